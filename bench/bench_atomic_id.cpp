@@ -0,0 +1,68 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/atomic_id.h>
+
+#include <mutex>
+#include <string>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+namespace {
+
+    //What std::atomic<uuid> does in common standard libraries
+    class locked_uuid {
+    public:
+        uuid load() const {
+            std::lock_guard guard(m_mutex);
+            return m_value;
+        }
+        void store(const uuid & val) {
+            std::lock_guard guard(m_mutex);
+            m_value = val;
+        }
+    private:
+        mutable std::mutex m_mutex;
+        uuid m_value;
+    };
+
+    constexpr size_t g_reads_per_thread = 1'000'000;
+
+    //Readers perform a fixed number of loads while writers keep storing until all readers are done.
+    //Reports the throughput of the readers.
+    template<class Holder>
+    void readers_vs_writers(const char * name) {
+        std::vector<unsigned> writer_counts = {0, 1};
+        if (hardware_threads() >= 4)
+            writer_counts.push_back(hardware_threads() / 2);
+        for (unsigned writer_count: writer_counts) {
+            const unsigned reader_count = std::max(hardware_threads() - writer_count, 1u);
+            Holder holder;
+            const uuid values[2] = {uuid::generate_random(), uuid::generate_random()};
+            std::atomic<unsigned> readers_running{reader_count};
+            auto elapsed = run_threads(reader_count + writer_count, [&](unsigned idx) {
+                if (idx < reader_count) {
+                    for (size_t i = 0; i < g_reads_per_thread; ++i) {
+                        auto val = holder.load();
+                        keep(val);
+                    }
+                    readers_running.fetch_sub(1);
+                } else {
+                    for (size_t i = 0; readers_running.load(std::memory_order_relaxed) != 0; ++i)
+                        holder.store(values[i & 1]);
+                }
+            });
+            std::string label = std::string(name) + " " + std::to_string(writer_count) + " writers";
+            report(label.c_str(), reader_count, reader_count * g_reads_per_thread, elapsed);
+        }
+    }
+}
+
+MUUID_BENCHMARK(atomic_id_readers_writers) {
+    std::printf("  atomic_id is %s\n", atomic_id<uuid>().is_lock_free() ? "lock free" : "using a seqlock");
+    readers_vs_writers<atomic_id<uuid>>("atomic_id");
+    readers_vs_writers<locked_uuid>("mutex");
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/cipher.h>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+MUUID_BENCHMARK(cipher_bulk) {
+    for (auto & kernel: active_kernels())
+        std::printf("  kernel %.*s: %.*s\n", int(kernel.name.size()), kernel.name.data(), 
+                                             int(kernel.tier.size()), kernel.tier.data());
+
+    constexpr size_t count = 1'000'000;
+    std::vector<uuid> ids(count);
+    for (auto & id: ids)
+        id = uuid::generate_random();
+    std::vector<uuid> out(count);
+    id_cipher cipher(std::array<uint8_t, 16>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16});
+
+    auto start = bench_clock::now();
+    cipher.encrypt(ids, out);
+    report("encrypt", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    cipher.encrypt_preserving_version(ids, out);
+    report("encrypt_preserving_version", 1, count, bench_clock::now() - start);
+}
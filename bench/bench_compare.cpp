@@ -0,0 +1,167 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Side by side comparison with other UUID libraries found on the system.
+//Each library is only compiled in if CMake found it.
+
+#include "bench_util.h"
+
+#include <modern-uuid/uuid.h>
+
+#if MUUID_BENCH_HAVE_LIBUUID
+    #include <uuid/uuid.h>
+#endif
+
+#if MUUID_BENCH_HAVE_BOOST
+    #include <boost/version.hpp>
+    #include <boost/uuid/uuid.hpp>
+    #include <boost/uuid/uuid_generators.hpp>
+    #include <boost/uuid/uuid_io.hpp>
+#endif
+
+#include <string>
+
+using namespace muuid::bench;
+
+namespace {
+
+    constexpr size_t g_generate_ops = 200'000;
+    constexpr size_t g_codec_ops = 1'000'000;
+    constexpr size_t g_batch = 1024;
+
+    template<class Generate>
+    void measure_generate(const char * label, Generate generate) {
+        keep(generate());
+        measure(label, g_generate_ops, [&]() {
+            for (size_t i = 0; i < g_generate_ops; ++i)
+                keep(generate());
+        });
+    }
+
+    std::vector<muuid::uuid> make_ids() {
+        std::vector<muuid::uuid> ret(g_batch);
+        for (auto & id: ret)
+            id = muuid::uuid::generate_random();
+        return ret;
+    }
+
+    std::vector<std::array<char, muuid::uuid::char_length>> make_strings(const std::vector<muuid::uuid> & ids) {
+        std::vector<std::array<char, muuid::uuid::char_length>> ret(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            ret[i] = ids[i].to_chars();
+        return ret;
+    }
+
+#if MUUID_BENCH_HAVE_BOOST
+    //Uses to_chars if this version of Boost has it and to_string otherwise
+    template<class U>
+    void boost_format(const U & u, char * dest) {
+        if constexpr (requires(char * p) { to_chars(u, p); }) {
+            to_chars(u, dest);
+        } else {
+            auto str = to_string(u);
+            memcpy(dest, str.data(), muuid::uuid::char_length);
+        }
+    }
+#endif
+}
+
+MUUID_BENCHMARK(compare_generate) {
+    measure_generate("modern-uuid v4", muuid::uuid::generate_random);
+    measure_generate("modern-uuid v1", muuid::uuid::generate_time_based);
+    measure_generate("modern-uuid v7", muuid::uuid::generate_unix_time_based);
+
+#if MUUID_BENCH_HAVE_LIBUUID
+    measure_generate("libuuid random", []() {
+        std::array<unsigned char, 16> ret;
+        uuid_generate_random(ret.data());
+        return ret;
+    });
+    measure_generate("libuuid time", []() {
+        std::array<unsigned char, 16> ret;
+        uuid_generate_time(ret.data());
+        return ret;
+    });
+#endif
+
+#if MUUID_BENCH_HAVE_BOOST
+    {
+        boost::uuids::random_generator gen;
+        measure_generate("Boost random_generator", [&]() { return gen(); });
+    }
+    {
+        boost::uuids::random_generator_mt19937 gen;
+        measure_generate("Boost random_generator_mt19937", [&]() { return gen(); });
+    }
+    #if BOOST_VERSION >= 108600
+    {
+        boost::uuids::time_generator_v1 gen;
+        measure_generate("Boost time_generator_v1", [&]() { return gen(); });
+    }
+    {
+        boost::uuids::time_generator_v7 gen;
+        measure_generate("Boost time_generator_v7", [&]() { return gen(); });
+    }
+    #endif
+#endif
+}
+
+MUUID_BENCHMARK(compare_codecs) {
+    auto ids = make_ids();
+    auto strs = make_strings(ids);
+
+    measure("modern-uuid to_chars", g_codec_ops, [&]() {
+        for (size_t i = 0; i < g_codec_ops; ++i)
+            keep(ids[i % g_batch].to_chars());
+    });
+    measure("modern-uuid from_chars", g_codec_ops, [&]() {
+        for (size_t i = 0; i < g_codec_ops; ++i)
+            keep(muuid::uuid::from_chars(strs[i % g_batch]));
+    });
+
+#if MUUID_BENCH_HAVE_LIBUUID
+    {
+        std::vector<std::array<char, 37>> zstrs(g_batch);
+        for (size_t i = 0; i < g_batch; ++i) {
+            memcpy(zstrs[i].data(), strs[i].data(), strs[i].size());
+            zstrs[i].back() = 0;
+        }
+        measure("libuuid uuid_unparse", g_codec_ops, [&]() {
+            char buf[37];
+            for (size_t i = 0; i < g_codec_ops; ++i) {
+                uuid_unparse(ids[i % g_batch].bytes.data(), buf);
+                keep(buf);
+            }
+        });
+        measure("libuuid uuid_parse", g_codec_ops, [&]() {
+            uuid_t out;
+            for (size_t i = 0; i < g_codec_ops; ++i) {
+                keep(uuid_parse(zstrs[i % g_batch].data(), out));
+                keep(out);
+            }
+        });
+    }
+#endif
+
+#if MUUID_BENCH_HAVE_BOOST
+    {
+        std::vector<boost::uuids::uuid> boost_ids(g_batch);
+        for (size_t i = 0; i < g_batch; ++i)
+            memcpy(boost_ids[i].data, ids[i].bytes.data(), 16);
+        measure("Boost to_chars/to_string", g_codec_ops, [&]() {
+            char buf[muuid::uuid::char_length];
+            for (size_t i = 0; i < g_codec_ops; ++i) {
+                boost_format(boost_ids[i % g_batch], buf);
+                keep(buf);
+            }
+        });
+        boost::uuids::string_generator parse;
+        measure("Boost string_generator", g_codec_ops, [&]() {
+            for (size_t i = 0; i < g_codec_ops; ++i) {
+                auto & str = strs[i % g_batch];
+                keep(parse(str.begin(), str.end()));
+            }
+        });
+    }
+#endif
+}
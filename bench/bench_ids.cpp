@@ -0,0 +1,130 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+namespace {
+
+    constexpr size_t g_generate_ops = 200'000;
+    constexpr size_t g_codec_ops = 1'000'000;
+
+    template<class Generate>
+    void measure_generate(const char * label, size_t ops, Generate generate) {
+        //warm up clock state and persistence
+        keep(generate());
+        measure(label, ops, [&]() {
+            for (size_t i = 0; i < ops; ++i)
+                keep(generate());
+        });
+    }
+
+    struct record {
+        uint64_t key;
+        uuid id;
+        ulid sort_key;
+        uint32_t flags;
+    };
+
+    //Compares generating directly into records with generating into a temporary
+    //vector and copying
+    template<class Id, class Generate, class Strided>
+    void measure_generate_records(const char * name, Id record::*member, Generate generate, Strided strided) {
+        constexpr size_t batch = 1024;
+        std::vector<record> records(batch);
+        std::vector<Id> ids(batch);
+        keep(generate());
+
+        std::string label = name;
+        measure((label + " one by one").c_str(), g_generate_ops, [&]() {
+            for (size_t i = 0; i < g_generate_ops; i += batch) {
+                for (auto & rec: records)
+                    rec.*member = generate();
+                keep(records[0]);
+            }
+        });
+        measure((label + " via vector").c_str(), g_generate_ops, [&]() {
+            for (size_t i = 0; i < g_generate_ops; i += batch) {
+                strided(ids, std::identity{});
+                for (size_t j = 0; j < batch; ++j)
+                    records[j].*member = ids[j];
+                keep(records[0]);
+            }
+        });
+        measure((label + " strided").c_str(), g_generate_ops, [&]() {
+            for (size_t i = 0; i < g_generate_ops; i += batch) {
+                strided(records, member);
+                keep(records[0]);
+            }
+        });
+    }
+
+    //Formats and parses a batch of distinct IDs round-robin so that the branch
+    //predictor cannot memorize a single value
+    template<class Id, class Generate>
+    void measure_codec(const char * name, Generate generate) {
+        constexpr size_t batch = 1024;
+        std::vector<Id> ids(batch);
+        for (auto & id: ids)
+            id = generate();
+        using chars_type = decltype(ids[0].to_chars());
+        std::vector<chars_type> strs(batch);
+        for (size_t i = 0; i < batch; ++i)
+            strs[i] = ids[i].to_chars();
+
+        std::string label = name;
+        measure((label + " to_chars").c_str(), g_codec_ops, [&]() {
+            for (size_t i = 0; i < g_codec_ops; ++i)
+                keep(ids[i % batch].to_chars());
+        });
+        measure((label + " from_chars").c_str(), g_codec_ops, [&]() {
+            for (size_t i = 0; i < g_codec_ops; ++i)
+                keep(Id::from_chars(strs[i % batch]));
+        });
+    }
+}
+
+MUUID_BENCHMARK(generate) {
+    measure_generate("uuid v1", g_generate_ops, uuid::generate_time_based);
+    measure_generate("uuid v4", g_generate_ops, uuid::generate_random);
+    measure_generate("uuid v6", g_generate_ops, uuid::generate_reordered_time_based);
+    measure_generate("uuid v7", g_generate_ops, uuid::generate_unix_time_based);
+    measure_generate("uuid v3 (md5)", g_generate_ops, []() {
+        return uuid::generate_md5(uuid::namespaces::dns, "www.example.com");
+    });
+    measure_generate("uuid v5 (sha1)", g_generate_ops, []() {
+        return uuid::generate_sha1(uuid::namespaces::dns, "www.example.com");
+    });
+    measure_generate("ulid", g_generate_ops, ulid::generate);
+    measure_generate("ulid unordered", g_generate_ops, []() { return ulid::generate_unordered(); });
+    measure_generate("nanoid", g_generate_ops, nanoid::generate);
+    measure_generate("cuid2 (sha3)", g_generate_ops, cuid2::generate);
+    measure_generate("cuid2 fast", g_generate_ops, []() { return cuid2::generate_fast(); });
+    measure_generate("cuid2<10> fast", g_generate_ops, []() { return basic_cuid2<10>::generate_fast(); });
+}
+
+MUUID_BENCHMARK(generate_records) {
+    measure_generate_records<uuid>("uuid v4", &record::id, uuid::generate_random,
+                                   [](auto & range, auto proj) { uuid::generate_random_into(range, proj); });
+    measure_generate_records<uuid>("uuid v7", &record::id, uuid::generate_unix_time_based,
+                                   [](auto & range, auto proj) { uuid::generate_unix_time_based_into(range, proj); });
+    measure_generate_records<ulid>("ulid", &record::sort_key, ulid::generate,
+                                   [](auto & range, auto proj) { ulid::generate_into(range, proj); });
+}
+
+MUUID_BENCHMARK(codecs) {
+    measure_codec<uuid>("uuid hex", uuid::generate_random);
+    measure_codec<ulid>("ulid base32", ulid::generate);
+    //nanoid conversions go through bit_packer
+    measure_codec<nanoid>("nanoid bit_packer", nanoid::generate);
+    //cuid2 conversions go through cuid2_repr
+    measure_codec<cuid2>("cuid2 cuid2_repr", cuid2::generate);
+    measure_codec<basic_cuid2<10>>("cuid2<10> 64-bit repr", basic_cuid2<10>::generate);
+}
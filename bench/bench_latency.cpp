@@ -0,0 +1,290 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Per-call latency distributions of all generators under various conditions.
+//
+//Each scenario runs in its own child process so that clock tick detection and clock state
+//start fresh. On Linux with glibc the system clock seen by the library is simulated 
+//(by interposing clock_gettime) to produce coarse readings and backward steps.
+
+#include "bench_util.h"
+#include "latency_histogram.h"
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+#include "../test/persistence.h"
+
+#if __has_include(<unistd.h>) && __has_include(<sys/wait.h>)
+    #include <unistd.h>
+    #include <sys/wait.h>
+    #define MUUID_BENCH_HAS_FORK 1
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <time.h>
+    #define MUUID_BENCH_SIMULATED_CLOCK 1
+#endif
+
+using namespace muuid;
+using namespace muuid::bench;
+
+namespace {
+
+    enum class clock_mode {
+        normal,
+        //1ms granularity like on WebAssembly
+        coarse,
+        //steps back by g_step_back every g_step_period
+        stepping_back
+    };
+
+    constexpr int64_t g_coarse_granularity_ns = 1'000'000;
+    constexpr int64_t g_step_period_ns = 10'000'000;
+    constexpr int64_t g_step_back_ns = 2'000'000;
+
+    std::atomic<clock_mode> g_clock_mode{clock_mode::normal};
+}
+
+#if MUUID_BENCH_SIMULATED_CLOCK
+
+extern "C" int clock_gettime(clockid_t id, struct timespec * ts) noexcept {
+    using real_func = int (*)(clockid_t, struct timespec *);
+    static const real_func real = reinterpret_cast<real_func>(dlsym(RTLD_NEXT, "clock_gettime"));
+
+    int ret = real(id, ts);
+    if (ret != 0 || id != CLOCK_REALTIME)
+        return ret;
+    auto mode = g_clock_mode.load(std::memory_order_relaxed);
+    if (mode == clock_mode::normal)
+        return ret;
+    int64_t ns = int64_t(ts->tv_sec) * 1'000'000'000 + ts->tv_nsec;
+    if (mode == clock_mode::coarse) {
+        ns -= ns % g_coarse_granularity_ns;
+    } else {
+        static const int64_t origin = ns;
+        ns -= ((ns - origin) / g_step_period_ns) * g_step_back_ns;
+    }
+    ts->tv_sec = time_t(ns / 1'000'000'000);
+    ts->tv_nsec = long(ns % 1'000'000'000);
+    return ret;
+}
+
+#endif
+
+namespace {
+
+    struct generator {
+        const char * name;
+        void (*generate)();
+    };
+
+    const generator g_generators[] = {
+        {"uuid v1", []() { keep(uuid::generate_time_based()); }},
+        {"uuid v4", []() { keep(uuid::generate_random()); }},
+        {"uuid v6", []() { keep(uuid::generate_reordered_time_based()); }},
+        {"uuid v7", []() { keep(uuid::generate_unix_time_based()); }},
+        {"ulid", []() { keep(ulid::generate()); }},
+        {"nanoid", []() { keep(nanoid::generate()); }},
+        {"cuid2", []() { keep(cuid2::generate()); }},
+    };
+
+    constexpr size_t g_calls_per_thread = 50'000;
+
+    std::vector<unsigned> thread_counts() {
+        std::vector<unsigned> ret;
+        for (unsigned count = 1; count <= hardware_threads(); count *= 2)
+            ret.push_back(count);
+        if (ret.back() != hardware_threads())
+            ret.push_back(hardware_threads());
+        return ret;
+    }
+
+    uint64_t time_call(void (*func)()) {
+        auto start = bench_clock::now();
+        func();
+        auto elapsed = bench_clock::now() - start;
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    void run_generators() {
+        for (auto & gen: g_generators) {
+            for (auto thread_count: thread_counts()) {
+                std::vector<latency_histogram> histograms(thread_count);
+                run_threads(thread_count, [&](unsigned idx) {
+                    auto & histogram = histograms[idx];
+                    for (size_t i = 0; i < g_calls_per_thread; ++i)
+                        histogram.record(time_call(gen.generate));
+                });
+                for (size_t i = 1; i < histograms.size(); ++i)
+                    histograms[0].merge(histograms[i]);
+                char label[64];
+                std::snprintf(label, sizeof(label), "%s x%u", gen.name, thread_count);
+                histograms[0].print(label);
+            }
+        }
+    }
+
+    //Runs func in a child process so that it starts with fresh library state 
+    template<class Func>
+    void isolated(Func func) {
+        std::fflush(stdout);
+    #if MUUID_BENCH_HAS_FORK
+        auto pid = fork();
+        if (pid == 0) {
+            func();
+            std::fflush(stdout);
+            _exit(0);
+        }
+        if (pid > 0) {
+            int status;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+                ;
+            return;
+        }
+    #endif
+        func();
+    }
+
+    template<class Data>
+    class raw_per_thread : public per_thread_file_clock_persistence<Data> {
+        using super = per_thread_file_clock_persistence<Data>;
+    public:
+        using data = Data;
+
+        raw_per_thread(const std::filesystem::path & path): super(path) {}
+
+        bool load(Data & d) override {
+            uint8_t buf[sizeof(Data)];
+            if (!super::read(buf))
+                return false;
+            memcpy(&d, buf, sizeof(d));
+            return true;
+        }
+        void store(const Data & d) override {
+            uint8_t buf[sizeof(Data)];
+            memcpy(buf, &d, sizeof(d));
+            super::write(buf);
+        }
+    };
+
+    auto persistence_path(const char * name) {
+        return std::filesystem::temp_directory_path() / 
+               ("muuid-bench-" + std::string(name) + "-" + std::to_string(sys_getpid()) + ".bin");
+    }
+}
+
+MUUID_BENCHMARK(latency_baseline) {
+    isolated(run_generators);
+}
+
+MUUID_BENCHMARK(latency_persistence) {
+    isolated([]() {
+        const char * const names[] = {"v1", "v6", "v7", "ulid"};
+        for (auto name: names)
+            std::filesystem::remove(persistence_path(name));
+
+        {
+            file_clock_persistence<raw_per_thread<uuid_persistence_data>> v1(persistence_path("v1"));
+            file_clock_persistence<raw_per_thread<uuid_persistence_data>> v6(persistence_path("v6"));
+            file_clock_persistence<raw_per_thread<uuid_persistence_data>> v7(persistence_path("v7"));
+            file_clock_persistence<raw_per_thread<ulid_persistence_data>> ulid_pers(persistence_path("ulid"));
+            set_time_based_persistence(&v1);
+            set_reordered_time_based_persistence(&v6);
+            set_unix_time_based_persistence(&v7);
+            set_ulid_persistence(&ulid_pers);
+
+            run_generators();
+
+            set_time_based_persistence(nullptr);
+            set_reordered_time_based_persistence(nullptr);
+            set_unix_time_based_persistence(nullptr);
+            set_ulid_persistence(nullptr);
+            //worker threads are gone, so only this one may still hold the persistence objects
+            uuid::generate_time_based();
+            uuid::generate_reordered_time_based();
+            uuid::generate_unix_time_based();
+            ulid::generate();
+        }
+
+        std::error_code ec;
+        for (auto name: names)
+            std::filesystem::remove(persistence_path(name), ec);
+    });
+}
+
+#if MUUID_BENCH_SIMULATED_CLOCK
+
+MUUID_BENCHMARK(latency_coarse_clock) {
+    isolated([]() {
+        g_clock_mode = clock_mode::coarse;
+        run_generators();
+    });
+}
+
+MUUID_BENCHMARK(latency_clock_stepping_back) {
+    isolated([]() {
+        g_clock_mode = clock_mode::stepping_back;
+        run_generators();
+    });
+}
+
+#endif
+
+#if MUUID_BENCH_HAS_FORK
+
+//Latency of the first call of each generator in a freshly forked child
+MUUID_BENCHMARK(latency_after_fork) {
+    constexpr size_t fork_count = 200;
+    constexpr size_t generator_count = std::size(g_generators);
+
+    for (auto & gen: g_generators)
+        gen.generate();
+
+    std::vector<latency_histogram> histograms(generator_count);
+    for (size_t i = 0; i < fork_count; ++i) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            std::printf("  pipe() failed\n");
+            return;
+        }
+        std::fflush(stdout);
+        auto pid = fork();
+        if (pid < 0) {
+            std::printf("  fork() failed\n");
+            return;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            uint64_t results[generator_count];
+            for (size_t j = 0; j < generator_count; ++j)
+                results[j] = time_call(g_generators[j].generate);
+            auto written = write(fds[1], results, sizeof(results));
+            _exit(written == ssize_t(sizeof(results)) ? 0 : 1);
+        }
+        close(fds[1]);
+        uint64_t results[generator_count];
+        size_t received = 0;
+        while (received < sizeof(results)) {
+            auto count = read(fds[0], reinterpret_cast<uint8_t *>(results) + received, sizeof(results) - received);
+            if (count <= 0)
+                break;
+            received += size_t(count);
+        }
+        close(fds[0]);
+        int status;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+            ;
+        if (received == sizeof(results)) {
+            for (size_t j = 0; j < generator_count; ++j)
+                histograms[j].record(results[j]);
+        }
+    }
+    for (size_t j = 0; j < generator_count; ++j)
+        histograms[j].print(g_generators[j].name);
+}
+
+#endif
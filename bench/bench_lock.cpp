@@ -0,0 +1,79 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/uuid.h>
+
+#include "../src/threading.h"
+
+using namespace muuid;
+using namespace muuid::bench;
+
+namespace {
+
+    //The plain spinlock previously used by the library, kept here for comparison
+    class pure_spinlock {
+    public:
+        void lock() noexcept {
+            for ( ; ; ) {
+                while (m_value.load(std::memory_order_relaxed)) {
+                    #ifdef MUUID_THREAD_YIELD
+                        MUUID_THREAD_YIELD;
+                    #endif
+                }
+                unsigned current = 0;
+                if (m_value.compare_exchange_strong(current, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+            }
+        }
+        void unlock() noexcept 
+            { m_value.store(0, std::memory_order_release); }
+    private:
+        std::atomic<unsigned> m_value{0};
+    };
+
+    //Total number of operations per run regardless of thread count so that 
+    //runs with different oversubscription are directly comparable
+    constexpr size_t g_total_ops = 2'000'000;
+
+    constexpr unsigned g_oversubscription[] = {1, 2, 4, 8};
+
+    template<class Lock>
+    void contend(const char * label) {
+        for (auto factor: g_oversubscription) {
+            unsigned thread_count = hardware_threads() * factor;
+            size_t ops_per_thread = g_total_ops / thread_count;
+            Lock lock;
+            uint64_t shared = 0;
+            auto elapsed = run_threads(thread_count, [&](unsigned) {
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    lock.lock();
+                    ++shared;
+                    lock.unlock();
+                }
+            });
+            report(label, thread_count, ops_per_thread * thread_count, elapsed);
+        }
+    }
+}
+
+MUUID_BENCHMARK(lock_contention) {
+    contend<pure_spinlock>("pure spinlock");
+    contend<impl::adaptive_lock_if_multithreaded>("adaptive lock");
+    contend<std::mutex>("std::mutex");
+}
+
+MUUID_BENCHMARK(generate_v7_contention) {
+    for (auto factor: g_oversubscription) {
+        unsigned thread_count = hardware_threads() * factor;
+        size_t ops_per_thread = g_total_ops / thread_count;
+        auto elapsed = run_threads(thread_count, [&](unsigned) {
+            for (size_t i = 0; i < ops_per_thread; ++i) {
+                auto val = uuid::generate_unix_time_based();
+                (void)val;
+            }
+        });
+        report("uuid v7", thread_count, ops_per_thread * thread_count, elapsed);
+    }
+}
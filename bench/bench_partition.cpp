@@ -0,0 +1,46 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/partition.h>
+
+#include <algorithm>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+MUUID_BENCHMARK(partition_by_time) {
+    //IDs spread over 2 days, in random order
+    constexpr size_t count = 1'000'000;
+    constexpr uint64_t span = 2 * 24 * 3'600'000;
+    const uint64_t now = 1'700'000'000'000;
+    std::vector<ulid> ids(count);
+    uint64_t state = 1;
+    for (auto & id: ids) {
+        id = ulid::generate();
+        state = state * 6364136223846793005 + 1442695040888963407;
+        uint64_t ms = now + (state >> 20) % span;
+        for (size_t i = 6; i > 0; --i, ms >>= 8)
+            id.bytes[i - 1] = uint8_t(ms);
+    }
+    std::vector<time_partition> parts;
+
+    auto work = ids;
+    auto start = bench_clock::now();
+    partition_by_time(work, std::chrono::hours(1), parts);
+    report("hourly", 1, count, bench_clock::now() - start);
+
+    work = ids;
+    start = bench_clock::now();
+    auto hour_of = [](const ulid & id) {
+        uint64_t ms = 0;
+        for (size_t i = 0; i < 6; ++i)
+            ms = (ms << 8) | id.bytes[i];
+        return ms / 3'600'000;
+    };
+    std::stable_sort(work.begin(), work.end(), [&](const ulid & lhs, const ulid & rhs) {
+        return hour_of(lhs) < hour_of(rhs);
+    });
+    report("hourly std::stable_sort", 1, count, bench_clock::now() - start);
+}
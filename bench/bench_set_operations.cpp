@@ -0,0 +1,71 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/set_operations.h>
+
+#include <algorithm>
+#include <string>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+static std::vector<uuid> make_sorted(size_t count) {
+    std::vector<uuid> ret(count);
+    for (auto & id: ret)
+        id = uuid::generate_random();
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+static void bench_sizes(const char * name, size_t lhs_size, size_t rhs_size) {
+    auto lhs = make_sorted(lhs_size);
+    auto rhs = make_sorted(rhs_size);
+    //make half of the smaller side common
+    auto & smaller = lhs_size < rhs_size ? lhs : rhs;
+    auto & larger = lhs_size < rhs_size ? rhs : lhs;
+    for (size_t i = 0; i < smaller.size(); i += 2)
+        smaller[i] = larger[i * (larger.size() / smaller.size())];
+    std::sort(smaller.begin(), smaller.end());
+    std::vector<uuid> dest(lhs_size + rhs_size);
+    const size_t count = lhs_size + rhs_size;
+    std::string prefix = name;
+
+    auto start = bench_clock::now();
+    size_t written = set_intersection(std::span(lhs), std::span(rhs), std::span(dest));
+    report((prefix + " set_intersection").c_str(), 1, count, bench_clock::now() - start);
+    keep(written);
+
+    start = bench_clock::now();
+    auto end = std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), dest.begin());
+    report((prefix + " std::set_intersection").c_str(), 1, count, bench_clock::now() - start);
+    keep(end);
+
+    start = bench_clock::now();
+    written = set_difference(std::span(lhs), std::span(rhs), std::span(dest));
+    report((prefix + " set_difference").c_str(), 1, count, bench_clock::now() - start);
+    keep(written);
+
+    start = bench_clock::now();
+    end = std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), dest.begin());
+    report((prefix + " std::set_difference").c_str(), 1, count, bench_clock::now() - start);
+    keep(end);
+
+    start = bench_clock::now();
+    written = set_union(std::span(lhs), std::span(rhs), std::span(dest));
+    report((prefix + " set_union").c_str(), 1, count, bench_clock::now() - start);
+    keep(written);
+
+    start = bench_clock::now();
+    end = std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), dest.begin());
+    report((prefix + " std::set_union").c_str(), 1, count, bench_clock::now() - start);
+    keep(end);
+}
+
+MUUID_BENCHMARK(set_operations) {
+    //warm up
+    bench_sizes("warmup", 10'000, 10'000);
+    bench_sizes("similar", 500'000, 500'000);
+    bench_sizes("skewed", 1'000, 1'000'000);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <modern-uuid/sharding.h>
+#include <modern-uuid/uuid.h>
+
+using namespace muuid;
+using namespace muuid::bench;
+
+MUUID_BENCHMARK(shard_of) {
+    constexpr size_t count = 1'000'000;
+    std::vector<uuid> random_ids(count), time_ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        random_ids[i] = uuid::generate_random();
+        time_ids[i] = uuid::generate_unix_time_based();
+    }
+    std::vector<uint32_t> out(count);
+    std::vector<uint64_t> shards(16);
+    for (size_t i = 0; i < shards.size(); ++i)
+        shards[i] = i;
+
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        out[i] = shard_of(random_ids[i], 1000);
+    report("jump v4 one by one", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    shard_of(random_ids, 1000, out);
+    report("jump v4 bulk", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    shard_of(time_ids, 1000, out);
+    report("jump v7 bulk", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        out[i] = rendezvous_shard_of(random_ids[i], shards);
+    report("rendezvous(16) v4 one by one", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    rendezvous_shard_of(random_ids, shards, out);
+    report("rendezvous(16) v4 bulk", 1, count, bench_clock::now() - start);
+}
+
+MUUID_BENCHMARK(sampled) {
+    constexpr size_t count = 1'000'000;
+    std::vector<uuid> random_ids(count), time_ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        random_ids[i] = uuid::generate_random();
+        time_ids[i] = uuid::generate_unix_time_based();
+    }
+    std::vector<uint64_t> mask(count / 64 + 1);
+    size_t total = 0;
+
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        total += sampled(random_ids[i], 0.01);
+    report("v4 one by one", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    total += sampled(random_ids, 0.01, mask);
+    report("v4 bulk", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        total += sampled(time_ids[i], 0.01);
+    report("v7 one by one", 1, count, bench_clock::now() - start);
+
+    start = bench_clock::now();
+    total += sampled(time_ids, 0.01, mask);
+    report("v7 bulk", 1, count, bench_clock::now() - start);
+
+    std::printf("  sampled: %zu\n", total);
+}
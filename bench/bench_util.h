@@ -0,0 +1,110 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MUUID_BENCH_UTIL_H_INCLUDED
+#define HEADER_MUUID_BENCH_UTIL_H_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "perf_counters.h"
+
+namespace muuid::bench {
+
+    using bench_clock = std::chrono::steady_clock;
+
+    using benchmark_func = void (*)();
+
+    struct benchmark_registrar {
+        benchmark_registrar(const char * name, benchmark_func func);
+    };
+
+    inline unsigned hardware_threads() {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    //Runs func(thread_index) on count threads that all start at the same time.
+    //Returns the wall time from the start to the moment the last thread finishes.
+    template<class Func>
+    bench_clock::duration run_threads(unsigned count, Func func) {
+        std::atomic<unsigned> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            threads.emplace_back([&, i]() {
+                ready.fetch_add(1, std::memory_order_acq_rel);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                func(i);
+            });
+        }
+        while (ready.load(std::memory_order_acquire) != count)
+            std::this_thread::yield();
+        auto start = bench_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto & thread: threads)
+            thread.join();
+        return bench_clock::now() - start;
+    }
+
+    inline void report(const char * label, unsigned threads, size_t ops, bench_clock::duration elapsed) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        double mops = ns ? double(ops) * 1000 / double(ns) : 0;
+        std::printf("  %-28s threads: %4u  ops: %10zu  time: %9.3f ms  %8.3f Mops/s\n",
+                    label, threads, ops, double(ns) / 1'000'000, mops);
+    }
+
+    //Prevents the compiler from optimizing away computation of val
+    template<class T>
+    inline void keep(const T & val) noexcept {
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&val) : "memory");
+    #else
+        static volatile const void * sink;
+        sink = &val;
+    #endif
+    }
+
+    inline perf_counters & thread_perf_counters() {
+        static thread_local perf_counters counters;
+        static std::atomic<bool> reported_unavailable{false};
+        if (!counters.any_available() && !reported_unavailable.exchange(true))
+            std::printf("  (hardware counters are not available)\n");
+        return counters;
+    }
+
+    //Runs func() that performs ops operations on the calling thread and reports the time
+    //and hardware counters per operation. Counters that are unavailable are reported as n/a.
+    template<class Func>
+    void measure(const char * label, size_t ops, Func func) {
+        auto & counters = thread_perf_counters();
+
+        counters.start();
+        auto start = bench_clock::now();
+        func();
+        auto elapsed = bench_clock::now() - start;
+        auto values = counters.stop();
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        std::printf("  %-28s %8.2f ns/op", label, double(ns) / double(ops));
+        for (size_t i = 0; i < perf_counters::counter_count; ++i) {
+            if (values[i])
+                std::printf("  %s: %8.2f", perf_counters::names[i], double(*values[i]) / double(ops));
+            else if (counters.any_available())
+                std::printf("  %s: %8s", perf_counters::names[i], "n/a");
+        }
+        std::printf("\n");
+    }
+}
+
+#define MUUID_BENCHMARK(name) \
+    static void name(); \
+    static ::muuid::bench::benchmark_registrar name##_registrar(#name, name); \
+    static void name()
+
+#endif
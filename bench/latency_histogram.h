@@ -0,0 +1,95 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MUUID_LATENCY_HISTOGRAM_H_INCLUDED
+#define HEADER_MUUID_LATENCY_HISTOGRAM_H_INCLUDED
+
+#include <bit>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+namespace muuid::bench {
+
+    //Log-linear histogram in the style of HdrHistogram
+    //
+    //Values below 128 are recorded exactly. Larger values are recorded with 64 buckets
+    //per power of 2, i.e. with precision better than 1.6%
+    class latency_histogram {
+    private:
+        static constexpr unsigned sub_bucket_bits = 7;
+        static constexpr uint64_t half_count = uint64_t(1) << (sub_bucket_bits - 1);
+        static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * half_count + half_count;
+    public:
+        latency_histogram(): m_counts(bucket_count) {}
+
+        void record(uint64_t value) noexcept {
+            ++m_counts[index_of(value)];
+            ++m_total;
+            if (value > m_max)
+                m_max = value;
+        }
+
+        void merge(const latency_histogram & other) noexcept {
+            for (size_t i = 0; i < bucket_count; ++i)
+                m_counts[i] += other.m_counts[i];
+            m_total += other.m_total;
+            if (other.m_max > m_max)
+                m_max = other.m_max;
+        }
+
+        uint64_t total() const noexcept
+            { return m_total; }
+
+        //Highest value equivalent to the value at percentile p (0 - 100)
+        uint64_t percentile(double p) const noexcept {
+            if (m_total == 0)
+                return 0;
+            auto target = uint64_t(double(m_total) * p / 100.0 + 0.5);
+            if (target == 0)
+                target = 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; ++i) {
+                seen += m_counts[i];
+                if (seen >= target)
+                    return std::min(highest_equivalent(i), m_max);
+            }
+            return m_max;
+        }
+
+        void print(const char * label) const {
+            std::printf("  %-24s n: %9llu  p50: %7llu  p90: %7llu  p99: %7llu  p99.9: %8llu  p99.99: %8llu  max: %9llu ns\n",
+                        label, 
+                        (unsigned long long)m_total,
+                        (unsigned long long)percentile(50),
+                        (unsigned long long)percentile(90),
+                        (unsigned long long)percentile(99),
+                        (unsigned long long)percentile(99.9),
+                        (unsigned long long)percentile(99.99),
+                        (unsigned long long)m_max);
+        }
+
+    private:
+        static size_t index_of(uint64_t value) noexcept {
+            unsigned width = unsigned(std::bit_width(value));
+            unsigned shift = width > sub_bucket_bits ? width - sub_bucket_bits : 0;
+            return size_t(shift * half_count + (value >> shift));
+        }
+
+        static uint64_t highest_equivalent(size_t index) noexcept {
+            if (index < 2 * half_count)
+                return index;
+            uint64_t shift = index / half_count - 1;
+            uint64_t sub = index - shift * half_count;
+            return ((sub + 1) << shift) - 1;
+        }
+
+    private:
+        std::vector<uint64_t> m_counts;
+        uint64_t m_total = 0;
+        uint64_t m_max = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "bench_util.h"
+
+#include <cstring>
+
+using namespace muuid::bench;
+
+namespace {
+    struct benchmark_entry {
+        const char * name;
+        benchmark_func func;
+    };
+
+    std::vector<benchmark_entry> & registry() {
+        static std::vector<benchmark_entry> ret;
+        return ret;
+    }
+}
+
+benchmark_registrar::benchmark_registrar(const char * name, benchmark_func func) {
+    registry().push_back({name, func});
+}
+
+//Usage: bench [name...]
+//With no arguments runs all benchmarks, otherwise only the ones whose names contain
+//any of the arguments.
+int main(int argc, char ** argv) {
+
+    auto selected = [&](const char * name) {
+        if (argc < 2)
+            return true;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strstr(name, argv[i]))
+                return true;
+        }
+        return false;
+    };
+
+    std::sort(registry().begin(), registry().end(), [](const auto & lhs, const auto & rhs) {
+        return std::strcmp(lhs.name, rhs.name) < 0;
+    });
+
+    std::printf("hardware threads: %u\n", hardware_threads());
+    for (auto & entry: registry()) {
+        if (!selected(entry.name))
+            continue;
+        std::printf("%s\n", entry.name);
+        entry.func();
+        std::fflush(stdout);
+    }
+}
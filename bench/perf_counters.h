@@ -0,0 +1,133 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MUUID_PERF_COUNTERS_H_INCLUDED
+#define HEADER_MUUID_PERF_COUNTERS_H_INCLUDED
+
+#include <array>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+    #define MUUID_BENCH_HAS_PERF_EVENTS 1
+#endif
+
+namespace muuid::bench {
+
+    //Hardware performance counters of the calling thread
+    //
+    //Each counter is opened separately so that the ones not supported by the CPU or 
+    //not permitted by the kernel (see /proc/sys/kernel/perf_event_paranoid) are simply 
+    //unavailable without affecting the others.
+    class perf_counters {
+    public:
+        enum counter : size_t {
+            cycles,
+            instructions,
+            branch_misses,
+            l1d_misses,
+            llc_misses,
+
+            counter_count
+        };
+
+        static constexpr const char * names[counter_count] = {
+            "cycles",
+            "instructions",
+            "branch-misses",
+            "L1d-misses",
+            "LLC-misses"
+        };
+
+        using values = std::array<std::optional<uint64_t>, counter_count>;
+
+    #if MUUID_BENCH_HAS_PERF_EVENTS
+
+        perf_counters() noexcept {
+            constexpr uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | 
+                                               (PERF_COUNT_HW_CACHE_OP_READ << 8) | 
+                                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            m_fds[cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            m_fds[instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            m_fds[branch_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+            m_fds[l1d_misses] = open(PERF_TYPE_HW_CACHE, l1d_read_miss);
+            m_fds[llc_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        }
+        ~perf_counters() noexcept {
+            for (int fd: m_fds) {
+                if (fd >= 0)
+                    close(fd);
+            }
+        }
+
+        bool any_available() const noexcept {
+            for (int fd: m_fds) {
+                if (fd >= 0)
+                    return true;
+            }
+            return false;
+        }
+
+        void start() noexcept {
+            for (int fd: m_fds) {
+                if (fd >= 0) {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+        }
+
+        values stop() noexcept {
+            for (int fd: m_fds) {
+                if (fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+            values ret;
+            for (size_t i = 0; i < counter_count; ++i) {
+                if (m_fds[i] < 0)
+                    continue;
+                //value, time enabled, time running
+                uint64_t data[3];
+                if (read(m_fds[i], data, sizeof(data)) != ssize_t(sizeof(data)) || data[2] == 0)
+                    continue;
+                //scale if the counter was multiplexed
+                double scale = data[2] < data[1] ? double(data[1]) / double(data[2]) : 1.0;
+                ret[i] = uint64_t(double(data[0]) * scale);
+            }
+            return ret;
+        }
+    private:
+        static int open(uint32_t type, uint64_t config) noexcept {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    private:
+        std::array<int, counter_count> m_fds;
+
+    #else
+
+        bool any_available() const noexcept 
+            { return false; }
+        void start() noexcept 
+            {}
+        values stop() noexcept 
+            { return {}; }
+
+    #endif
+    };
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_ATOMIC_ID_H_INCLUDED
+#define HEADER_MODERN_UUID_ATOMIC_ID_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+#include <atomic>
+
+namespace muuid {
+
+    namespace impl {
+        template<class T>
+        concept atomic_id_value = id_type<T> && sizeof(T) == 16 && std::is_trivially_copyable_v<T>;
+
+        struct alignas(16) atomic_id_storage {
+            //The bytes of the value. Accessed via 16-byte atomic instructions when available.
+            std::atomic<uint64_t> words[2];
+            //Sequence counter of the seqlock used otherwise. Odd while the value is being written.
+            std::atomic<uint64_t> sequence{0};
+        };
+
+        MUUID_EXPORTED bool atomic_id_is_lock_free() noexcept;
+        MUUID_EXPORTED void atomic_id_load(const atomic_id_storage & storage, uint64_t (&dest)[2]) noexcept;
+        MUUID_EXPORTED void atomic_id_store(atomic_id_storage & storage, const uint64_t (&val)[2]) noexcept;
+        MUUID_EXPORTED void atomic_id_exchange(atomic_id_storage & storage, const uint64_t (&val)[2], uint64_t (&old)[2]) noexcept;
+        MUUID_EXPORTED bool atomic_id_compare_exchange(atomic_id_storage & storage,
+                                                       uint64_t (&expected)[2], const uint64_t (&desired)[2]) noexcept;
+    }
+
+    /**
+     * Atomic holder of a 16-byte ID such as uuid or ulid
+     *
+     * Unlike `std::atomic<uuid>`, which uses a lock in common standard libraries, this class uses
+     * 16-byte compare-and-swap instructions (`cmpxchg16b` on x64, `casp` or exclusive pair
+     * instructions on ARM64). On x64 CPUs that support AVX plain 16-byte loads and stores are used,
+     * since they are guaranteed to be atomic on such CPUs, making load() as cheap as for a 64-bit value.
+     * Elsewhere (including x64 with `MUUID_CPU_TIER` below `avx2`) load() is also a compare-and-swap.
+     * It writes the cache line, so concurrent readers contend with each other as much as with writers.
+     *
+     * Where 16-byte atomic instructions are unavailable the value is protected by a seqlock:
+     * writers are serialized while readers retry if a write was in progress and never block writers.
+     * is_lock_free() tells which implementation is used.
+     *
+     * All operations are sequentially consistent. The memory order arguments are accepted for
+     * compatibility with `std::atomic`.
+     * Values are compared by their bytes which, for the ID types, is the same as `operator==`.
+     */
+    template<impl::atomic_id_value T>
+    class atomic_id {
+    public:
+        using value_type = T;
+    public:
+        /// Holds a default constructed (e.g. nil) ID
+        atomic_id() noexcept: atomic_id(T{})
+            {}
+        atomic_id(const T & val) noexcept {
+            uint64_t words[2];
+            to_words(val, words);
+            this->m_storage.words[0].store(words[0], std::memory_order_relaxed);
+            this->m_storage.words[1].store(words[1], std::memory_order_relaxed);
+        }
+        atomic_id(const atomic_id &) = delete;
+        atomic_id & operator=(const atomic_id &) = delete;
+
+        /// Whether 16-byte atomic instructions rather than a seqlock are used on this CPU
+        bool is_lock_free() const noexcept
+            { return impl::atomic_id_is_lock_free(); }
+
+        T load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+            uint64_t words[2];
+            impl::atomic_id_load(this->m_storage, words);
+            return from_words(words);
+        }
+        operator T() const noexcept
+            { return this->load(); }
+
+        void store(const T & val, std::memory_order = std::memory_order_seq_cst) noexcept {
+            uint64_t words[2];
+            to_words(val, words);
+            impl::atomic_id_store(this->m_storage, words);
+        }
+        T operator=(const T & val) noexcept {
+            this->store(val);
+            return val;
+        }
+
+        T exchange(const T & val, std::memory_order = std::memory_order_seq_cst) noexcept {
+            uint64_t words[2], old[2];
+            to_words(val, words);
+            impl::atomic_id_exchange(this->m_storage, words, old);
+            return from_words(old);
+        }
+
+        /**
+         * Replaces the value with `desired` if it is equal to `expected`
+         *
+         * Otherwise stores the current value in `expected`. The weak form never fails spuriously.
+         * @return whether the value was replaced
+         */
+        bool compare_exchange_strong(T & expected, const T & desired,
+                                     std::memory_order = std::memory_order_seq_cst) noexcept {
+            uint64_t expected_words[2], desired_words[2];
+            to_words(expected, expected_words);
+            to_words(desired, desired_words);
+            if (impl::atomic_id_compare_exchange(this->m_storage, expected_words, desired_words))
+                return true;
+            expected = from_words(expected_words);
+            return false;
+        }
+        bool compare_exchange_strong(T & expected, const T & desired,
+                                     std::memory_order, std::memory_order) noexcept
+            { return this->compare_exchange_strong(expected, desired); }
+        bool compare_exchange_weak(T & expected, const T & desired,
+                                   std::memory_order = std::memory_order_seq_cst) noexcept
+            { return this->compare_exchange_strong(expected, desired); }
+        bool compare_exchange_weak(T & expected, const T & desired,
+                                   std::memory_order, std::memory_order) noexcept
+            { return this->compare_exchange_strong(expected, desired); }
+
+    private:
+        static void to_words(const T & val, uint64_t (&dest)[2]) noexcept
+            { memcpy(dest, &val, sizeof(dest)); }
+        static T from_words(const uint64_t (&src)[2]) noexcept {
+            T ret;
+            memcpy(&ret, src, sizeof(src));
+            return ret;
+        }
+    private:
+        impl::atomic_id_storage m_storage;
+    };
+}
+
+#endif
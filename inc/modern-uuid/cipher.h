@@ -0,0 +1,131 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_CIPHER_H_INCLUDED
+#define HEADER_MODERN_UUID_CIPHER_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+namespace muuid {
+
+    namespace impl {
+        template<class T>
+        concept cipher_id = std::is_same_v<T, uuid> || std::is_same_v<T, ulid>;
+    }
+
+    /**
+     * Keyed 128-bit permutation of IDs
+     *
+     * Maps uuid and ulid values to opaque 16-byte values and back. This allows exposing
+     * IDs that carry information (such as creation timestamp of UUID v7 or ULID)
+     * without a mapping table: translation between internal and public IDs is a computation.
+     *
+     * The permutation is Speck128/128 block cipher keyed with a 128-bit key.
+     *
+     * Objects of this class are immutable and can be used concurrently from multiple threads.
+     */
+    class id_cipher {
+    public:
+        using key_type = std::array<uint8_t, 16>;
+    public:
+        /// Constructs the cipher from a 128-bit key
+        constexpr explicit id_cipher(std::span<const uint8_t, 16> key) noexcept {
+            uint64_t a = 0, b = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                b = (b << 8) | key[i];
+                a = (a << 8) | key[i + 8];
+            }
+            for (size_t i = 0; i < std::size(this->m_round_keys); ++i) {
+                this->m_round_keys[i] = a;
+                b = ((b >> 8) | (b << 56)) + a;
+                b ^= uint64_t(i);
+                a = ((a << 3) | (a >> 61)) ^ b;
+            }
+        }
+
+        /// Encrypts an ID producing an opaque value of the same type
+        template<impl::cipher_id Id>
+        auto encrypt(const Id & src) const noexcept -> Id {
+            Id ret;
+            this->encrypt_blocks(&src.bytes, &ret.bytes, 1);
+            return ret;
+        }
+        /// Reverses encrypt()
+        template<impl::cipher_id Id>
+        auto decrypt(const Id & src) const noexcept -> Id {
+            Id ret;
+            this->decrypt_blocks(&src.bytes, &ret.bytes, 1);
+            return ret;
+        }
+
+        /**
+         * Encrypts multiple UUIDs
+         *
+         * Processes `std::min(src.size(), dest.size())` elements. The source and destination 
+         * can be the same range but must not otherwise overlap.
+         */
+        void encrypt(std::span<const uuid> src, std::span<uuid> dest) const noexcept {
+            this->encrypt_blocks(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                 std::min(src.size(), dest.size()));
+        }
+        /// Reverses encrypt() of multiple UUIDs
+        void decrypt(std::span<const uuid> src, std::span<uuid> dest) const noexcept {
+            this->decrypt_blocks(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                 std::min(src.size(), dest.size()));
+        }
+        /// Encrypts multiple ULIDs
+        void encrypt(std::span<const ulid> src, std::span<ulid> dest) const noexcept {
+            this->encrypt_blocks(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                 std::min(src.size(), dest.size()));
+        }
+        /// Reverses encrypt() of multiple ULIDs
+        void decrypt(std::span<const ulid> src, std::span<ulid> dest) const noexcept {
+            this->decrypt_blocks(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                 std::min(src.size(), dest.size()));
+        }
+
+        /**
+         * Encrypts a UUID keeping its version and variant
+         *
+         * The 4 version bits and the top 2 variant bits are copied unchanged
+         * and the remaining 122 bits are encrypted. Thus an encrypted variant::standard
+         * UUID is still a valid UUID of the same type.
+         */
+        auto encrypt_preserving_version(const uuid & src) const noexcept -> uuid {
+            uuid ret;
+            this->encrypt_blocks_preserving_version(&src.bytes, &ret.bytes, 1);
+            return ret;
+        }
+        /// Reverses encrypt_preserving_version()
+        auto decrypt_preserving_version(const uuid & src) const noexcept -> uuid {
+            uuid ret;
+            this->decrypt_blocks_preserving_version(&src.bytes, &ret.bytes, 1);
+            return ret;
+        }
+
+        /// Encrypts multiple UUIDs keeping their version and variant
+        void encrypt_preserving_version(std::span<const uuid> src, std::span<uuid> dest) const noexcept {
+            this->encrypt_blocks_preserving_version(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                                    std::min(src.size(), dest.size()));
+        }
+        /// Reverses encrypt_preserving_version() of multiple UUIDs
+        void decrypt_preserving_version(std::span<const uuid> src, std::span<uuid> dest) const noexcept {
+            this->decrypt_blocks_preserving_version(reinterpret_cast<const block *>(src.data()), reinterpret_cast<block *>(dest.data()),
+                                                    std::min(src.size(), dest.size()));
+        }
+
+    private:
+        using block = std::array<uint8_t, 16>;
+        static_assert(sizeof(uuid) == sizeof(block) && sizeof(ulid) == sizeof(block));
+
+        MUUID_EXPORTED void encrypt_blocks(const block * src, block * dest, size_t count) const noexcept;
+        MUUID_EXPORTED void decrypt_blocks(const block * src, block * dest, size_t count) const noexcept;
+        MUUID_EXPORTED void encrypt_blocks_preserving_version(const block * src, block * dest, size_t count) const noexcept;
+        MUUID_EXPORTED void decrypt_blocks_preserving_version(const block * src, block * dest, size_t count) const noexcept;
+    private:
+        uint64_t m_round_keys[32] = {};
+    };
+}
+
+#endif
@@ -31,6 +31,8 @@
 #include <chrono>
 #include <numeric>
 #include <algorithm>
+#include <functional>
+#include <ranges>
 #include <istream>
 #include <ostream>
 
@@ -391,6 +393,129 @@ namespace muuid
         private:
             std::array<uint64_t, bit_packer::units> m_units{};
         };
+
+        template<class T>
+        struct is_byte_array : std::false_type {};
+        template<size_t N>
+        struct is_byte_array<std::array<uint8_t, N>> : std::true_type {};
+
+        /// A range whose elements (or their fields selected by Proj) can be assigned an Id
+        template<class R, class Proj, class Id>
+        concept projectable_range = std::ranges::forward_range<R> && 
+            std::invocable<Proj &, std::ranges::range_reference_t<R>> &&
+            std::assignable_from<std::invoke_result_t<Proj &, std::ranges::range_reference_t<R>>, const Id &>;
+
+        /**
+         * Generates IDs into elements of a range or their fields
+         * 
+         * `generate(dest, stride, count)` must write `count` IDs to `dest`, `dest + stride` etc. 
+         * If the range is contiguous and the projection is a data member pointer (or identity) the IDs 
+         * are generated directly in place. Otherwise they are generated in small chunks and assigned 
+         * via the projection.
+         */
+        template<class Id, class R, class Proj, class Generate>
+        void generate_projected(R && records, Proj & proj, Generate generate) {
+            using reference = std::ranges::range_reference_t<R>;
+            if constexpr (std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                          (std::is_member_object_pointer_v<Proj> || std::is_same_v<Proj, std::identity>) &&
+                          std::is_same_v<std::invoke_result_t<Proj &, reference>, Id &>) {
+                const size_t size = std::ranges::size(records);
+                if (size == 0)
+                    return;
+                auto first = std::ranges::data(records);
+                generate(std::addressof(std::invoke(proj, *first)), sizeof(*first), size);
+            } else {
+                constexpr size_t chunk = 64;
+                Id buf[chunk];
+                auto it = std::ranges::begin(records);
+                const auto end = std::ranges::end(records);
+                while (it != end) {
+                    auto start = it;
+                    size_t count = 0;
+                    for ( ; count < chunk && it != end; ++count, ++it) {}
+                    generate(buf, sizeof(Id), count);
+                    for (size_t i = 0; i < count; ++i, ++start)
+                        std::invoke(proj, *start) = buf[i];
+                }
+            }
+        }
+
+        /// Any of the ID types in this library
+        template<class T>
+        concept id_type = is_byte_array<std::remove_cv_t<decltype(T::bytes)>>::value && 
+            requires(const T & val) { { hash_value(val) } -> std::same_as<size_t>; };
+
+        /**
+         * Hashing traits for ID types
+         * 
+         * `uniform()` returns whether all the bits of a given value are (close to) uniformly random
+         * and so the value can be hashed without extra mixing.
+         */
+        template<class T>
+        struct hash_traits {
+            static constexpr bool uniform(const T &) noexcept
+                { return false; }
+        };
+
+        template<size_t N>
+        constexpr size_t fold_bytes(const std::array<uint8_t, N> & bytes) noexcept {
+            size_t temp;
+            const uint8_t * data = bytes.data();
+            size_t ret = 0;
+
+            if constexpr (constexpr auto remainder = N % sizeof(size_t)) {
+                data = impl::reinterpret_bytes_partial<0, remainder>(data, temp);
+                ret ^= temp;
+            }
+            for(unsigned i = 0; i < N / sizeof(size_t); ++i) {
+                data = impl::reinterpret_bytes(data, temp);
+                ret ^= temp;
+            }
+            return ret;
+        }
+
+        constexpr uint64_t rotl64(uint64_t val, unsigned count) noexcept 
+            { return (val << count) | (val >> (64 - count)); }
+
+        template<unsigned CompressionRounds, unsigned FinalizationRounds, size_t N>
+        constexpr uint64_t siphash(uint64_t k0, uint64_t k1, const std::array<uint8_t, N> & bytes) noexcept {
+            uint64_t v0 = k0 ^ 0x736f6d6570736575;
+            uint64_t v1 = k1 ^ 0x646f72616e646f6d;
+            uint64_t v2 = k0 ^ 0x6c7967656e657261;
+            uint64_t v3 = k1 ^ 0x7465646279746573;
+
+            auto round = [&]() {
+                v0 += v1; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32);
+                v2 += v3; v3 = rotl64(v3, 16); v3 ^= v2;
+                v0 += v3; v3 = rotl64(v3, 21); v3 ^= v0;
+                v2 += v1; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32);
+            };
+            auto compress = [&](uint64_t m) {
+                v3 ^= m;
+                for (unsigned i = 0; i < CompressionRounds; ++i)
+                    round();
+                v0 ^= m;
+            };
+
+            size_t i = 0;
+            for ( ; N - i >= 8; i += 8) {
+                uint64_t m = 0;
+                for (size_t j = 8; j > 0; --j)
+                    m = (m << 8) | bytes[i + j - 1];
+                compress(m);
+            }
+            uint64_t last = uint64_t(N) << 56;
+            for (size_t j = 0; i + j < N; ++j)
+                last |= uint64_t(bytes[i + j]) << (8 * j);
+            compress(last);
+
+            v2 ^= 0xff;
+            for (unsigned r = 0; r < FinalizationRounds; ++r)
+                round();
+            return v0 ^ v1 ^ v2 ^ v3;
+        }
+
+        MUUID_EXPORTED auto get_process_hash_key() noexcept -> const std::array<uint64_t, 2> &;
     }
 
 
@@ -420,6 +545,46 @@ namespace muuid
      */
     MUUID_EXPORTED void set_node_id(std::span<const uint8_t, 6> id);
 
+    /// Source of time readings for all time-based ID generation
+    enum class clock_source {
+        /// `std::chrono::system_clock` (default)
+        system,
+        /** 
+         * CPU timestamp counter calibrated against `std::chrono::system_clock`
+         * 
+         * This is an invariant TSC on x86/x64 and the generic timer on ARM64. The counter is 
+         * periodically re-anchored to `std::chrono::system_clock` so it follows its adjustments.
+         */
+        cpu_counter
+    };
+
+    /**
+     * Sets the source of time readings for time-based ID generation
+     * 
+     * This call affects all subsequent generations of time-based UUIDs and ULIDs.
+     * 
+     * @returns `true` on success. `false` if the source is not usable on this machine
+     * (e.g. the CPU counter is not invariant), in which case the current source is not changed.
+     */
+    MUUID_EXPORTED bool set_clock_source(clock_source source) noexcept;
+
+    /// Implementation of an operation selected at runtime based on CPU capabilities
+    struct kernel_info {
+        /// Name of the operation
+        std::string_view name;
+        /// Instruction set tier of the selected implementation, e.g. "sse2", "avx2" or "neon"
+        std::string_view tier;
+    };
+
+    /**
+     * Returns implementations of all runtime dispatched operations
+     * 
+     * The implementations are selected once per process based on CPU capabilities. You can 
+     * limit the selection by setting `MUUID_CPU_TIER` environment variable to one of
+     * "generic", "sse2", "avx2", "avx512" or "neon" before the first use of the library.
+     */
+    MUUID_EXPORTED auto active_kernels() noexcept -> std::span<const kernel_info>;
+
     /// Callback interface to handle persistence of clock data
     template<class Data>
     class generic_clock_persistence {
@@ -499,6 +664,84 @@ namespace muuid
         generic_clock_persistence(const generic_clock_persistence &) noexcept = default;
         generic_clock_persistence & operator=(const generic_clock_persistence &) noexcept = default;
     };
+
+    /**
+     * Hasher for IDs whose bits are uniformly random
+     * 
+     * Simply XORs the bits of the ID together. This is the fastest option and is
+     * appropriate for UUID versions 3, 4 and 5, NanoIDs and Cuid2s. 
+     * Do not use it for time-based IDs.
+     */
+    struct fold_hash {
+        using is_transparent = void;
+
+        template<impl::id_type T>
+        constexpr size_t operator()(const T & val) const noexcept 
+            { return impl::fold_bytes(val.bytes); }
+    };
+
+    /**
+     * Hasher that fully mixes all the bits of an ID
+     * 
+     * This is the same as `std::hash` and appropriate for time-based IDs with 
+     * low entropy prefixes.
+     */
+    struct mixing_hash {
+        using is_transparent = void;
+
+        template<impl::id_type T>
+        constexpr size_t operator()(const T & val) const noexcept 
+            { return hash_value(val); }
+    };
+
+    /**
+     * Hasher that selects fold_hash or mixing_hash depending on the ID type and value
+     * 
+     * For example, UUIDs of version 4 are folded while UUIDs of version 7 are mixed.
+     */
+    struct id_hash {
+        using is_transparent = void;
+
+        template<impl::id_type T>
+        constexpr size_t operator()(const T & val) const noexcept {
+            if (impl::hash_traits<T>::uniform(val))
+                return impl::fold_bytes(val.bytes);
+            return hash_value(val);
+        }
+    };
+
+    /**
+     * Keyed hasher resistant to hash flooding
+     * 
+     * Uses SipHash-1-3 with a 128-bit key. Use it when IDs come from untrusted
+     * sources. A default constructed object uses a random key generated once per process.
+     */
+    class keyed_hash {
+    public:
+        using is_transparent = void;
+        
+        /// Constructs the hasher with a random per-process key
+        keyed_hash() noexcept {
+            auto & key = impl::get_process_hash_key();
+            this->m_k0 = key[0];
+            this->m_k1 = key[1];
+        }
+
+        /// Constructs the hasher with a specific key
+        constexpr explicit keyed_hash(std::span<const uint8_t, 16> key) noexcept {
+            for (size_t i = 8; i > 0; --i) {
+                this->m_k0 = (this->m_k0 << 8) | key[i - 1];
+                this->m_k1 = (this->m_k1 << 8) | key[i + 7];
+            }
+        }
+
+        template<impl::id_type T>
+        constexpr size_t operator()(const T & val) const noexcept 
+            { return size_t(impl::siphash<1, 3>(this->m_k0, this->m_k1, val.bytes)); }
+    private:
+        uint64_t m_k0 = 0;
+        uint64_t m_k1 = 0;
+    };
 }
 
 #endif
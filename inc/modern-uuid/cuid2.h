@@ -11,24 +11,65 @@ namespace muuid {
     namespace impl {
 
     
+        //Base36 digits of a cuid2 accumulated into a big-endian number stored in Bytes bytes.
+        //The implementation is selected at compile time by size: a single 64-bit word, 
+        //a 128-bit integer (or two 64-bit halves) or an array of 32-bit limbs.
+
+        template<size_t Bytes>
+        class cuid2_repr64 {
+            static_assert(Bytes <= 8);
+        public:
+            constexpr cuid2_repr64() = default;
+
+            constexpr cuid2_repr64(std::span<const uint8_t, Bytes> src) {
+                for (auto b: src) {
+                    m_data <<= 8;
+                    m_data |= b;
+                }
+            }
+
+            constexpr void get_bytes(std::span<uint8_t, Bytes> dst) const {
+                uint64_t val = m_data;
+                for (size_t i = Bytes; i != 0; --i) {
+                    dst[i - 1] = val & 0xFF;
+                    val >>= 8;
+                }
+            }
+
+            constexpr void push_base36_digit(uint8_t val) {
+                m_data *= 36;
+                m_data += val;
+            }
+
+            constexpr uint8_t pop_base36_digit() {
+                uint8_t ret = m_data % 36;
+                m_data /= 36;
+                return ret;
+            }
+        private:
+            uint64_t m_data = 0;
+        };
+    
     #if defined(__SIZEOF_INT128__) && !(defined(__clang__) && defined(_WIN32))
     #ifdef __GNUC__
         #define MUUID_CPP_EXTENSION __extension__
     #endif
-        class cuid2_repr {
+        template<size_t Bytes>
+        class cuid2_repr128 {
+            static_assert(Bytes > 8 && Bytes <= 16);
         public:
-            constexpr cuid2_repr() = default;
+            constexpr cuid2_repr128() = default;
 
-            constexpr cuid2_repr(std::span<const uint8_t, 15> src) {
+            constexpr cuid2_repr128(std::span<const uint8_t, Bytes> src) {
                 for (auto b: src) {
                     m_data <<= 8;
                     m_data |= b;
                 }
             }
 
-            constexpr void get_bytes(std::span<uint8_t, 15> dst) const {
+            constexpr void get_bytes(std::span<uint8_t, Bytes> dst) const {
                 MUUID_CPP_EXTENSION unsigned __int128 val = m_data;
-                for (int i = 15; i != 0; --i) {
+                for (size_t i = Bytes; i != 0; --i) {
                     dst[i - 1] = val & 0xFF;
                     val >>= 8;
                 }
@@ -50,26 +91,28 @@ namespace muuid {
 
     #else
 
-        class cuid2_repr {
+        template<size_t Bytes>
+        class cuid2_repr128 {
+            static_assert(Bytes > 8 && Bytes <= 16);
         public:
-            constexpr cuid2_repr() = default;
+            constexpr cuid2_repr128() = default;
 
-            constexpr cuid2_repr(std::span<const uint8_t, 15> src) {
-                int i = 0;
-                for ( ; i < 7; ++i) {
+            constexpr cuid2_repr128(std::span<const uint8_t, Bytes> src) {
+                size_t i = 0;
+                for ( ; i < Bytes - 8; ++i) {
                     m_parts[0] <<= 8;
                     m_parts[0] |= src[i];
                 }
-                for ( ; i < 15; ++i) {
+                for ( ; i < Bytes; ++i) {
                     m_parts[1] <<= 8;
                     m_parts[1] |= src[i];
                 }
             }
 
-            constexpr void get_bytes(std::span<uint8_t, 15> dst) const {
+            constexpr void get_bytes(std::span<uint8_t, Bytes> dst) const {
                 uint64_t val = m_parts[1];
-                int i = 15;
-                for ( ; i != 7; --i) {
+                size_t i = Bytes;
+                for ( ; i != Bytes - 8; --i) {
                     dst[i - 1] = val & 0xFF;
                     val >>= 8;
                 }
@@ -139,6 +182,73 @@ namespace muuid {
 
     #endif
 
+        template<size_t Bytes>
+        class cuid2_repr_wide {
+            static constexpr size_t limb_count = (Bytes + 3) / 4;
+        public:
+            constexpr cuid2_repr_wide() = default;
+
+            constexpr cuid2_repr_wide(std::span<const uint8_t, Bytes> src) {
+                for (auto b: src) {
+                    uint32_t carry = b;
+                    for (size_t i = limb_count; i != 0; --i) {
+                        uint64_t val = (uint64_t(m_limbs[i - 1]) << 8) | carry;
+                        m_limbs[i - 1] = uint32_t(val);
+                        carry = uint32_t(val >> 32);
+                    }
+                }
+            }
+
+            constexpr void get_bytes(std::span<uint8_t, Bytes> dst) const {
+                for (size_t i = 0; i < Bytes; ++i) {
+                    size_t shift = (Bytes - 1 - i) * 8;
+                    dst[i] = uint8_t(m_limbs[limb_count - 1 - shift / 32] >> (shift % 32));
+                }
+            }
+
+            constexpr void push_base36_digit(uint8_t val) {
+                uint64_t carry = val;
+                for (size_t i = limb_count; i != 0; --i) {
+                    uint64_t x = uint64_t(m_limbs[i - 1]) * 36 + carry;
+                    m_limbs[i - 1] = uint32_t(x);
+                    carry = x >> 32;
+                }
+            }
+
+            constexpr uint8_t pop_base36_digit() {
+                uint64_t rem = 0;
+                for (size_t i = 0; i < limb_count; ++i) {
+                    uint64_t x = (rem << 32) | m_limbs[i];
+                    m_limbs[i] = uint32_t(x / 36);
+                    rem = x % 36;
+                }
+                return uint8_t(rem);
+            }
+        private:
+            std::array<uint32_t, limb_count> m_limbs{};
+        };
+
+        template<size_t Bytes>
+        using cuid2_repr = std::conditional_t<(Bytes <= 8), cuid2_repr64<Bytes>,
+                           std::conditional_t<(Bytes <= 16), cuid2_repr128<Bytes>, 
+                                                             cuid2_repr_wide<Bytes>>>;
+
+        //Number of bytes needed to store the given number of base36 digits
+        consteval size_t cuid2_digit_bytes(size_t digits) {
+            cuid2_repr_wide<32> max;
+            for (size_t i = 0; i < digits; ++i)
+                max.push_base36_digit(35);
+            std::array<uint8_t, 32> bytes{};
+            max.get_bytes(bytes);
+            size_t ret = bytes.size();
+            for (size_t i = 0; i < bytes.size() && bytes[i] == 0; ++i)
+                --ret;
+            return ret;
+        }
+
+        MUUID_EXPORTED void generate_cuid2(std::span<uint8_t> dest, std::span<const uint8_t> max_digits);
+        MUUID_EXPORTED void generate_cuid2_fast(std::span<uint8_t> dest, std::span<const uint8_t> max_digits);
+
 
         template<class T> struct cuid2_char_traits {
             static constexpr T l = T(u8'l');
@@ -243,7 +353,16 @@ namespace muuid {
         #undef MUUID_CUID2_ALPHABET
     }
 
-    class cuid2 {
+    /**
+     * CUID2 of a given length
+     * 
+     * The reference CUID2 implementation allows lengths from 2 to 32 characters. The first
+     * character is a letter and the rest are base36 digits. The object stores the letter in the
+     * first byte followed by the minimal number of bytes needed for the digits.
+     */
+    template<size_t CharCount>
+    class basic_cuid2 {
+        static_assert(CharCount >= 2 && CharCount <= 32, "CUID2 length must be between 2 and 32");
     public:
         /// Whether to print cuid2 in lower or upper case
         enum format {
@@ -252,105 +371,149 @@ namespace muuid {
         };
 
         /// Number of characters in string representation of Cuid2
-        static constexpr size_t char_length = 24;
+        static constexpr size_t char_length = CharCount;
+
+        /// Number of bytes in binary representation of Cuid2
+        static constexpr size_t bytes_count = impl::cuid2_digit_bytes(CharCount - 1) + 1;
     
     private:
+        static constexpr size_t digit_bytes = bytes_count - 1;
+        using repr = impl::cuid2_repr<digit_bytes>;
+
+        static consteval auto make_max_digits() -> std::array<uint8_t, digit_bytes> {
+            std::array<uint8_t, digit_bytes> ret;
+            repr max;
+            for (size_t i = 1; i < CharCount; ++i)
+                max.push_base36_digit(35);
+            max.get_bytes(ret);
+            return ret;
+        }
+        static constexpr std::array<uint8_t, digit_bytes> max_digits = make_max_digits();
+
         template<impl::char_like T>
-        static constexpr bool read(const T * str, std::array<uint8_t, 16> & dest) noexcept {
+        static constexpr bool read(const T * str, std::array<uint8_t, bytes_count> & dest) noexcept {
             uint8_t first = impl::cuid2_alphabet::decode(str[0]);
             if (first < 10 || first >= impl::cuid2_alphabet::size)
                 return false;
             first -= 10;
-            impl::cuid2_repr repr;
-            for(size_t i = 1; i < cuid2::char_length; ++i) {
+            repr digits;
+            for(size_t i = 1; i < basic_cuid2::char_length; ++i) {
                 T c = str[i];
                 uint8_t val = impl::cuid2_alphabet::decode(c);
                 if (val >= impl::cuid2_alphabet::size)
                     return false;
-                repr.push_base36_digit(val);
+                digits.push_base36_digit(val);
             }
             dest[0] = first;
-            repr.get_bytes(std::span<uint8_t, 15>(&dest[1], 15));
+            digits.get_bytes(std::span<uint8_t, digit_bytes>(&dest[1], digit_bytes));
             return true;
         }
 
         template<impl::char_like T>
-        static constexpr void write(const std::array<uint8_t, 16> & src, T * str, format fmt) noexcept {
+        static constexpr void write(const std::array<uint8_t, bytes_count> & src, T * str, format fmt) noexcept {
             uint8_t first = src[0] + 10;
             str[0] = impl::cuid2_alphabet::encode<T>(fmt, first);
-            impl::cuid2_repr repr(std::span<const uint8_t, 15>(&src[1], 15));
-            for(int i = cuid2::char_length; i != 1; --i) {
-                uint8_t val = repr.pop_base36_digit();
+            repr digits(std::span<const uint8_t, digit_bytes>(&src[1], digit_bytes));
+            for(size_t i = basic_cuid2::char_length; i != 1; --i) {
+                uint8_t val = digits.pop_base36_digit();
                 str[i - 1] = impl::cuid2_alphabet::encode<T>(fmt, val);
             }
         }
     public:
-        std::array<uint8_t, 16> bytes{};
+        std::array<uint8_t, bytes_count> bytes{};
 
     public:
         ///Constructs a zeroed out cuid2
-        constexpr cuid2() noexcept = default;
+        constexpr basic_cuid2() noexcept = default;
 
         ///Constructs cuid2 from a string literal
         template<impl::char_like T>
-        consteval cuid2(const T (&src)[cuid2::char_length + 1]) noexcept {            
-            if (!cuid2::read(src, this->bytes) || src[cuid2::char_length] != 0)
+        consteval basic_cuid2(const T (&src)[CharCount + 1]) noexcept {            
+            if (!basic_cuid2::read(src, this->bytes) || src[CharCount] != 0)
                 impl::invalid_constexpr_call("invalid cuid2 string");
         }
 
         /// Generates a cuid2
-        MUUID_EXPORTED static auto generate() -> cuid2;
+        static auto generate() -> basic_cuid2 {
+            basic_cuid2 ret;
+            impl::generate_cuid2(ret.bytes, basic_cuid2::max_digits);
+            return ret;
+        }
+
+        /**
+         * Generates a cuid2 without hashing
+         * 
+         * The digits are derived directly from the random generator keystream mixed with
+         * the counter and host fingerprint instead of a SHA3 hash of them. This is much faster
+         * than generate() and produces values of the same format, but it is not the canonical
+         * CUID2 algorithm.
+         */
+        static auto generate_fast() -> basic_cuid2 {
+            basic_cuid2 ret;
+            impl::generate_cuid2_fast(ret.bytes, basic_cuid2::max_digits);
+            return ret;
+        }
+
+        /// Fills the destination with cuid2s generated as if by generate_fast()
+        static void generate_fast(std::span<basic_cuid2> dest) {
+            static_assert(sizeof(basic_cuid2) == bytes_count);
+            if (dest.empty())
+                return;
+            impl::generate_cuid2_fast(std::span<uint8_t>(dest.front().bytes.data(), dest.size() * bytes_count), 
+                                      basic_cuid2::max_digits);
+        }
 
         /// Returns a Max cuid2
-        static constexpr cuid2 max() noexcept 
-            { return cuid2("ZZZZZZZZZZZZZZZZZZZZZZZZ"); }
+        static constexpr basic_cuid2 max() noexcept {
+            constexpr impl::ct_string<char, CharCount + 1> ctstr('z');
+            return basic_cuid2(ctstr.chars);
+        }
 
         /// Resets the object to a Nil cuid2
         constexpr void clear() noexcept {
-            *this = cuid2();
+            *this = basic_cuid2();
         }
 
-        constexpr friend auto operator==(const cuid2 & lhs, const cuid2 & rhs) noexcept -> bool = default;
-        constexpr friend auto operator<=>(const cuid2 & lhs, const cuid2 & rhs) noexcept -> std::strong_ordering = default;
+        constexpr friend auto operator==(const basic_cuid2 & lhs, const basic_cuid2 & rhs) noexcept -> bool = default;
+        constexpr friend auto operator<=>(const basic_cuid2 & lhs, const basic_cuid2 & rhs) noexcept -> std::strong_ordering = default;
 
-        /// Constructs cuid2 from a span of 16 byte-like objects
+        /// Constructs cuid2 from a span of bytes_count byte-like objects
         template<impl::byte_like Byte>
-        static constexpr std::optional<cuid2> from_bytes(std::span<Byte, 16> src) noexcept {
+        static constexpr std::optional<basic_cuid2> from_bytes(std::span<Byte, bytes_count> src) noexcept {
 
             if (uint8_t(src[0]) > 25)
                 return {};
-            auto max_bytes = cuid2::max().bytes;
-            if (std::lexicographical_compare(max_bytes.begin() + 1, max_bytes.end(),
+            if (std::lexicographical_compare(basic_cuid2::max_digits.begin(), basic_cuid2::max_digits.end(),
                                              src.begin() + 1, src.end(),
                                             [](auto lhs, auto rhs) {
                                                 return uint8_t(lhs) < uint8_t(rhs);
                                             }))
                 return {};
 
-            cuid2 ret;
+            basic_cuid2 ret;
             for(size_t i = 0; i < src.size(); ++i) 
                 ret.bytes[i] = uint8_t(src[i]);
             return ret;
         }
 
-        /// Constructs cuid2 from anything convertible to a span of 16 byte-like objects
+        /// Constructs cuid2 from anything convertible to a span of bytes_count byte-like objects
         template<class T>
         requires( !impl::is_span<T> && requires(const T & x) { 
             std::span{x}; 
             requires impl::byte_like<std::remove_reference_t<decltype(*std::span{x}.begin())>>; 
-            requires decltype(std::span{x})::extent == 16;
+            requires decltype(std::span{x})::extent == bytes_count;
         })
-        static constexpr std::optional<cuid2> from_bytes(const T & src) noexcept {
-            return cuid2::from_bytes(std::span{src});
+        static constexpr std::optional<basic_cuid2> from_bytes(const T & src) noexcept {
+            return basic_cuid2::from_bytes(std::span{src});
         }
 
         /// Parses cuid2 from a span of characters
         template<impl::char_like T, size_t Extent>
-        static constexpr std::optional<cuid2> from_chars(std::span<const T, Extent> src) noexcept {
-            if (src.size() < cuid2::char_length)
+        static constexpr std::optional<basic_cuid2> from_chars(std::span<const T, Extent> src) noexcept {
+            if (src.size() < basic_cuid2::char_length)
                 return std::nullopt;
-            cuid2 ret;
-            if (!cuid2::read(src.data(), ret.bytes))
+            basic_cuid2 ret;
+            if (!basic_cuid2::read(src.data(), ret.bytes))
                 return std::nullopt;
             return ret;
         }
@@ -362,23 +525,23 @@ namespace muuid {
             requires impl::char_like<std::remove_cvref_t<decltype(*std::span{x}.begin())>>; 
         })
         static constexpr auto from_chars(const T & src) noexcept
-            { return cuid2::from_chars(std::span{src}); }
+            { return basic_cuid2::from_chars(std::span{src}); }
 
 
         /// Formats cuid2 into a span of characters
         template<impl::char_like T, size_t Extent>
         [[nodiscard]]
-        constexpr auto to_chars(std::span<T, Extent> dest, format fmt = cuid2::lowercase) const noexcept ->
+        constexpr auto to_chars(std::span<T, Extent> dest, format fmt = basic_cuid2::lowercase) const noexcept ->
             std::conditional_t<Extent == std::dynamic_extent, bool, void> {
             
             if constexpr (Extent == std::dynamic_extent) {
-                if (dest.size() < cuid2::char_length)
+                if (dest.size() < basic_cuid2::char_length)
                     return false;
             } else {
-                static_assert(Extent >= cuid2::char_length, "destination is too small");
+                static_assert(Extent >= basic_cuid2::char_length, "destination is too small");
             }
 
-            cuid2::write(this->bytes, dest.data(), fmt);
+            basic_cuid2::write(this->bytes, dest.data(), fmt);
 
             if constexpr (Extent == std::dynamic_extent)
                 return true;
@@ -398,8 +561,8 @@ namespace muuid {
 
         /// Returns a character array with formatted cuid2
         template<impl::char_like T = char>
-        constexpr auto to_chars(format fmt = lowercase) const noexcept -> std::array<T, cuid2::char_length> {
-            std::array<T, cuid2::char_length> ret;
+        constexpr auto to_chars(format fmt = lowercase) const noexcept -> std::array<T, basic_cuid2::char_length> {
+            std::array<T, basic_cuid2::char_length> ret;
             this->to_chars(ret, fmt);
             return ret;
         }
@@ -412,17 +575,17 @@ namespace muuid {
         /// Returns a string with formatted cuid2
         auto to_string(format fmt = lowercase) const -> std::basic_string<T>
         {
-            std::basic_string<T> ret(cuid2::char_length, T(0));
+            std::basic_string<T> ret(basic_cuid2::char_length, T(0));
             (void)to_chars(ret, fmt);
             return ret;
         }
 
         /// Prints cuid2 into an ostream
         template<impl::char_like T>
-        friend std::basic_ostream<T> & operator<<(std::basic_ostream<T> & str, const cuid2 & val) {
+        friend std::basic_ostream<T> & operator<<(std::basic_ostream<T> & str, const basic_cuid2 & val) {
             const auto flags = str.flags();
-            const cuid2::format fmt = (flags & std::ios_base::uppercase ? cuid2::uppercase : cuid2::lowercase);
-            std::array<T, cuid2::char_length> buf;
+            const basic_cuid2::format fmt = (flags & std::ios_base::uppercase ? basic_cuid2::uppercase : basic_cuid2::lowercase);
+            std::array<T, basic_cuid2::char_length> buf;
             val.to_chars(buf, fmt);
             std::copy(buf.begin(), buf.end(), std::ostreambuf_iterator<T>(str));
             return str;
@@ -430,19 +593,19 @@ namespace muuid {
 
         /// Reads cuid2 from an istream
         template<impl::char_like T>
-        friend std::basic_istream<T> & operator>>(std::basic_istream<T> & str, cuid2 & val) {
+        friend std::basic_istream<T> & operator>>(std::basic_istream<T> & str, basic_cuid2 & val) {
             typename std::basic_istream<T>::sentry sentry(str);
             if (!sentry)
                 return str;
             
-            std::array<T, cuid2::char_length> buf;
+            std::array<T, basic_cuid2::char_length> buf;
             str.read(buf.data(), buf.size());
             if (str.gcount() != std::streamsize(buf.size())) {
                 str.setstate(std::ios_base::failbit);
                 return str;
             }
             
-            if (auto maybe_val = cuid2::from_chars(buf))
+            if (auto maybe_val = basic_cuid2::from_chars(buf))
                 val = *maybe_val;
             else
                 str.setstate(std::ios_base::failbit);
@@ -450,12 +613,17 @@ namespace muuid {
         }
 
         /// Returns hash code for the cuid2
-        friend constexpr size_t hash_value(const cuid2 & val) noexcept {
-            static_assert(sizeof(cuid2) > sizeof(size_t) && sizeof(cuid2) % sizeof(size_t) == 0);
+        friend constexpr size_t hash_value(const basic_cuid2 & val) noexcept {
+            
             size_t temp;
             const uint8_t * data = val.bytes.data();
             size_t ret = 0;
-            for(unsigned i = 0; i < sizeof(cuid2) / sizeof(size_t); ++i) {
+
+            if constexpr (constexpr auto remainder = sizeof(val.bytes) % sizeof(size_t)) {
+                data = impl::reinterpret_bytes_partial<0, remainder>(data, temp);
+                ret = impl::hash_combine(ret, temp);
+            }
+            for(unsigned i = 0; i < sizeof(basic_cuid2) / sizeof(size_t); ++i) {
                 data = impl::reinterpret_bytes(data, temp);
                 ret = impl::hash_combine(ret, temp);
             }
@@ -463,13 +631,23 @@ namespace muuid {
         }
     };
 
+    using cuid2 = basic_cuid2<24>;
+
     static_assert(sizeof(cuid2) == 16);
 
     namespace impl {
-        template<class Derived, class CharT>
+        template<size_t CharCount>
+        struct hash_traits<basic_cuid2<CharCount>> {
+            static constexpr bool uniform(const basic_cuid2<CharCount> &) noexcept
+                { return true; }
+        };
+
+        template<class Derived, size_t CharCount, class CharT>
         struct cuid2_formatter_base
         {
-            cuid2::format fmt = cuid2::lowercase;
+            using cuid2 = basic_cuid2<CharCount>;
+
+            typename cuid2::format fmt = cuid2::lowercase;
 
             template<class ParseContext>
             constexpr auto parse(ParseContext & ctx) -> typename ParseContext::iterator
@@ -492,7 +670,7 @@ namespace muuid {
             }
 
             template <typename FormatContext>
-            auto format(cuid2 val, FormatContext & ctx) const -> decltype(ctx.out()) 
+            auto format(const cuid2 & val, FormatContext & ctx) const -> decltype(ctx.out()) 
             {
                 std::array<CharT, cuid2::char_length> buf;
                 val.to_chars(buf, this->fmt);
@@ -503,10 +681,10 @@ namespace muuid {
 }
 
 /// std::hash specialization for cuid2
-template<>
-struct std::hash<muuid::cuid2> {
+template<size_t CharCount>
+struct std::hash<muuid::basic_cuid2<CharCount>> {
 
-    constexpr size_t operator()(const muuid::cuid2 & val) const noexcept {
+    constexpr size_t operator()(const muuid::basic_cuid2<CharCount> & val) const noexcept {
         return hash_value(val);
     }
 };
@@ -515,9 +693,9 @@ struct std::hash<muuid::cuid2> {
 #if MUUID_SUPPORTS_STD_FORMAT
 
 /// cuid2 formatter for std::format
-template<class CharT>
-struct std::formatter<::muuid::cuid2, CharT> : 
-    public ::muuid::impl::cuid2_formatter_base<std::formatter<::muuid::cuid2, CharT>, CharT>
+template<size_t CharCount, class CharT>
+struct std::formatter<::muuid::basic_cuid2<CharCount>, CharT> : 
+    public ::muuid::impl::cuid2_formatter_base<std::formatter<::muuid::basic_cuid2<CharCount>, CharT>, CharCount, CharT>
 {
     [[noreturn]] constexpr void raise_exception(const char * message) {
         MUUID_THROW(std::format_error(message));
@@ -531,9 +709,9 @@ struct std::formatter<::muuid::cuid2, CharT> :
 MUUID_IGNORE_UNREACHABLE_BEGIN
 
 /// cuid2 formatter for fmt::format
-template<class CharT>
-struct fmt::formatter<::muuid::cuid2, CharT> : 
-    public ::muuid::impl::cuid2_formatter_base<fmt::formatter<::muuid::cuid2, CharT>, CharT>
+template<size_t CharCount, class CharT>
+struct fmt::formatter<::muuid::basic_cuid2<CharCount>, CharT> : 
+    public ::muuid::impl::cuid2_formatter_base<fmt::formatter<::muuid::basic_cuid2<CharCount>, CharT>, CharCount, CharT>
 {
     [[noreturn]] constexpr void raise_exception(const char * message) {
         FMT_THROW(fmt::format_error(message));
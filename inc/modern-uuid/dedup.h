@@ -0,0 +1,307 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_DEDUP_H_INCLUDED
+#define HEADER_MODERN_UUID_DEDUP_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace muuid {
+
+    namespace impl {
+        template<class T>
+        concept dedup_id = std::is_same_v<T, uuid> || std::is_same_v<T, ulid>;
+
+        /// Unix time in milliseconds of a UUID v7 or ULID. Other UUIDs have no usable timestamp.
+        template<dedup_id Id>
+        constexpr auto dedup_timestamp(const Id & id) noexcept -> std::optional<int64_t> {
+            if constexpr (std::is_same_v<Id, uuid>) {
+                if (id.get_variant() != uuid::variant::standard || id.get_type() != uuid::type::unix_time_based)
+                    return std::nullopt;
+            }
+            uint64_t ret = 0;
+            for (size_t i = 0; i < 6; ++i)
+                ret = (ret << 8) | id.bytes[i];
+            return int64_t(ret);
+        }
+    }
+
+    /// Result of dedup_cache::insert()
+    enum class dedup_result {
+        /// The ID was not seen before and has been recorded
+        inserted,
+        /// The ID is already in the cache
+        duplicate,
+        /// The ID timestamp is outside of the window (or the ID has no timestamp)
+        outside_window,
+        /// The bucket for the ID timestamp has no room left
+        full
+    };
+
+    /**
+     * Concurrent time-windowed cache of recently seen IDs
+     *
+     * Deduplicates UUIDs v7 or ULIDs (e.g. idempotency keys) using the timestamps embedded in them
+     * rather than insertion times. The cache only keeps IDs with timestamps in
+     * `[now - window, now + resolution)`. IDs outside of that range are rejected by looking at the
+     * timestamp alone.
+     *
+     * Internally the IDs are stored in a ring of buckets each covering `resolution` milliseconds.
+     * When a new time period starts the bucket that held the oldest period is cleared as a whole.
+     * Each bucket is a fixed size open addressing hash table holding up to `max_per_bucket` IDs so the memory
+     * use is fixed at construction: about `32 * max_per_bucket * (window / resolution + 3)` bytes.
+     *
+     * All methods can be called concurrently from multiple threads. Lookups via contains() never wait.
+     * insert() waits only while another thread clears an expired bucket or is in the middle
+     * of inserting an ID with the same first 8 bytes.
+     */
+    template<impl::dedup_id Id>
+    class dedup_cache {
+    private:
+        //Top bit of the timestamp. It is 0 for all timestamps before year 6429 (and
+        //we reject any that are not) so we use it to mark slots being written.
+        static constexpr uint64_t pending_bit = uint64_t(1) << 63;
+        //Slots claimed for a period that expired during insertion. They never match any ID
+        //(it corresponds to timestamp 0 which we reject) but, unlike empty slots, do not end probing.
+        //It must not have pending_bit set or threads waiting on the slot would never stop.
+        static constexpr uint64_t abandoned = 1;
+        //Marks buckets being cleared
+        static constexpr uint64_t clearing_bit = uint64_t(1) << 63;
+
+        struct slot {
+            //First and last 8 bytes of the ID. A slot is empty when first is 0, which is never
+            //the case for IDs we accept.
+            std::atomic<uint64_t> first{0};
+            std::atomic<uint64_t> last{0};
+        };
+
+        struct bucket {
+            //Index of the time period (plus 1) stored in the bucket, 0 if none
+            std::atomic<uint64_t> period{0};
+            //Number of IDs in the low 32 bits and the low 32 bits of the period they belong to in 
+            //the high ones. Reservations are only made for the matching period so they cannot 
+            //survive the bucket being reused.
+            std::atomic<uint64_t> count{0};
+        };
+    public:
+        using clock = std::chrono::system_clock;
+    public:
+        /**
+         * Constructs the cache
+         *
+         * @param window how far back from the current time IDs are kept
+         * @param resolution time period covered by each bucket. Must be positive.
+         * @param max_per_bucket maximum number of IDs with timestamps in the same `resolution`
+         * period. Must be positive and less than 2^32.
+         */
+        dedup_cache(std::chrono::milliseconds window, std::chrono::milliseconds resolution, size_t max_per_bucket):
+            m_window(window.count()),
+            m_resolution(resolution.count()),
+            m_max_per_bucket(max_per_bucket) {
+
+            if (window.count() < 0 || resolution.count() <= 0 || max_per_bucket == 0 || 
+                uint64_t(max_per_bucket) > std::numeric_limits<uint32_t>::max())
+                MUUID_THROW(std::invalid_argument("invalid dedup_cache parameters"));
+
+            //Timestamps in [now - window, now + resolution) span at most this many periods
+            this->m_bucket_count = size_t((this->m_window + this->m_resolution - 1) / this->m_resolution) + 3;
+            //Keep the load factor at most 50%
+            this->m_slots_per_bucket = std::bit_ceil(max_per_bucket * 2);
+            this->m_buckets = std::make_unique<bucket[]>(this->m_bucket_count);
+            this->m_slots = std::make_unique<slot[]>(this->m_bucket_count * this->m_slots_per_bucket);
+        }
+        dedup_cache(const dedup_cache &) = delete;
+        dedup_cache & operator=(const dedup_cache &) = delete;
+
+        /// Records an ID if it is within the window relative to the current system time
+        auto insert(const Id & id) noexcept -> dedup_result
+            { return this->insert(id, clock::now()); }
+
+        /// Records an ID if it is within the window relative to `now`
+        auto insert(const Id & id, clock::time_point now) noexcept -> dedup_result {
+            auto period = this->period_of(id, now);
+            if (!period)
+                return dedup_result::outside_window;
+
+            bucket & b = this->m_buckets[*period % this->m_bucket_count];
+            if (!this->acquire_bucket(b, *period))
+                return dedup_result::outside_window;
+
+            auto [first, last] = split(id);
+            slot * slots = this->slots_of(b);
+            const size_t mask = this->m_slots_per_bucket - 1;
+            auto ret = dedup_result::full;
+            for (size_t i = hash_value(id) & mask, n = 0; n < this->m_slots_per_bucket; ++n, i = (i + 1) & mask) {
+                slot & s = slots[i];
+                uint64_t current = s.first.load(std::memory_order_acquire);
+                if (current == 0) {
+                    if (!this->reserve(b, *period))
+                        break;
+                    if (s.first.compare_exchange_strong(current, first | pending_bit, std::memory_order_acquire)) {
+                        s.last.store(last, std::memory_order_relaxed);
+                        s.first.store(first, std::memory_order_release);
+                        //If the bucket has not started being reused by now, the reuse will clear our 
+                        //slot. Otherwise we may have written to it after it was cleared.
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        if (b.period.load(std::memory_order_relaxed) != *period) {
+                            uint64_t expected = first;
+                            s.first.compare_exchange_strong(expected, abandoned, std::memory_order_relaxed);
+                            this->unreserve(b, *period);
+                            return dedup_result::outside_window;
+                        }
+                        ret = dedup_result::inserted;
+                        break;
+                    }
+                    this->unreserve(b, *period);
+                }
+                if ((current & ~pending_bit) != first)
+                    continue;
+                while (current & pending_bit) {
+                    std::this_thread::yield();
+                    current = s.first.load(std::memory_order_acquire);
+                }
+                if (current == first && s.last.load(std::memory_order_relaxed) == last) {
+                    ret = dedup_result::duplicate;
+                    break;
+                }
+            }
+            //If the bucket was reused for a later period while we were busy our ID has expired
+            if (b.period.load(std::memory_order_acquire) != *period)
+                return dedup_result::outside_window;
+            return ret;
+        }
+
+        /// Returns whether an ID within the window relative to the current system time is in the cache
+        bool contains(const Id & id) const noexcept
+            { return this->contains(id, clock::now()); }
+
+        /// Returns whether an ID within the window relative to `now` is in the cache
+        bool contains(const Id & id, clock::time_point now) const noexcept {
+            auto period = this->period_of(id, now);
+            if (!period)
+                return false;
+
+            const bucket & b = this->m_buckets[*period % this->m_bucket_count];
+            if (b.period.load(std::memory_order_acquire) != *period)
+                return false;
+
+            auto [first, last] = split(id);
+            const slot * slots = this->slots_of(b);
+            const size_t mask = this->m_slots_per_bucket - 1;
+            bool ret = false;
+            for (size_t i = hash_value(id) & mask, n = 0; n < this->m_slots_per_bucket; ++n, i = (i + 1) & mask) {
+                const slot & s = slots[i];
+                uint64_t current = s.first.load(std::memory_order_acquire);
+                if (current == 0)
+                    break;
+                //Slots still being written (with pending bit set) are not yet in the cache
+                if (current == first && s.last.load(std::memory_order_relaxed) == last) {
+                    ret = true;
+                    break;
+                }
+            }
+            return ret && b.period.load(std::memory_order_acquire) == *period;
+        }
+
+        /// Number of buckets in the ring
+        size_t bucket_count() const noexcept
+            { return this->m_bucket_count; }
+
+    private:
+        static auto split(const Id & id) noexcept -> std::pair<uint64_t, uint64_t> {
+            uint64_t first = 0, last = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                first = (first << 8) | id.bytes[i];
+                last = (last << 8) | id.bytes[i + 8];
+            }
+            return {first, last};
+        }
+
+        auto period_of(const Id & id, clock::time_point now) const noexcept -> std::optional<uint64_t> {
+            auto timestamp = impl::dedup_timestamp(id);
+            if (!timestamp)
+                return std::nullopt;
+            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+            if (*timestamp < now_ms - this->m_window || *timestamp >= now_ms + this->m_resolution)
+                return std::nullopt;
+            //see pending_bit and slot::first
+            if (*timestamp == 0 || *timestamp >= (int64_t(1) << 47))
+                return std::nullopt;
+            return uint64_t(*timestamp / this->m_resolution) + 1;
+        }
+
+        static constexpr uint64_t count_tag(uint64_t period) noexcept
+            { return uint64_t(uint32_t(period)) << 32; }
+
+        //Reserves room for an ID in a bucket holding the given period
+        bool reserve(bucket & b, uint64_t period) noexcept {
+            const uint64_t tag = count_tag(period);
+            uint64_t current = b.count.load(std::memory_order_relaxed);
+            do {
+                if ((current & ~uint64_t(0xFFFFFFFF)) != tag || uint32_t(current) >= this->m_max_per_bucket)
+                    return false;
+            } while (!b.count.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+            return true;
+        }
+
+        //Releases reservation made by reserve() unless the bucket has been reused since
+        void unreserve(bucket & b, uint64_t period) noexcept {
+            const uint64_t tag = count_tag(period);
+            uint64_t current = b.count.load(std::memory_order_relaxed);
+            do {
+                if ((current & ~uint64_t(0xFFFFFFFF)) != tag)
+                    return;
+            } while (!b.count.compare_exchange_weak(current, current - 1, std::memory_order_relaxed));
+        }
+
+        slot * slots_of(const bucket & b) const noexcept
+            { return this->m_slots.get() + (&b - this->m_buckets.get()) * this->m_slots_per_bucket; }
+
+        //Makes sure the bucket holds the given period clearing it if it holds an older one.
+        //Returns false if it already holds a newer one.
+        bool acquire_bucket(bucket & b, uint64_t period) noexcept {
+            for ( ; ; ) {
+                uint64_t current = b.period.load(std::memory_order_acquire);
+                if (current == period)
+                    return true;
+                if (current & clearing_bit) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (current > period)
+                    return false;
+                if (b.period.compare_exchange_strong(current, period | clearing_bit, std::memory_order_acquire)) {
+                    //pairs with the fence in insert()
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    slot * slots = this->slots_of(b);
+                    for (size_t i = 0; i < this->m_slots_per_bucket; ++i) {
+                        slots[i].first.store(0, std::memory_order_relaxed);
+                        slots[i].last.store(0, std::memory_order_relaxed);
+                    }
+                    b.count.store(count_tag(period), std::memory_order_relaxed);
+                    b.period.store(period, std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+    private:
+        int64_t m_window;
+        int64_t m_resolution;
+        size_t m_max_per_bucket;
+        size_t m_bucket_count = 0;
+        size_t m_slots_per_bucket = 0;
+        std::unique_ptr<bucket[]> m_buckets;
+        std::unique_ptr<slot[]> m_slots;
+    };
+}
+
+#endif
@@ -369,6 +369,12 @@ namespace muuid {
     static_assert(sizeof(nanoid) == 16);
 
     namespace impl {
+        template<class Alphabet, size_t CharCount>
+        struct hash_traits<basic_nanoid<Alphabet, CharCount>> {
+            static constexpr bool uniform(const basic_nanoid<Alphabet, CharCount> &) noexcept
+                { return true; }
+        };
+
         template<class Derived, class Alphabet, size_t CharCount, class CharT>
         struct nanoid_formatter_base {
             template<class ParseContext>
@@ -0,0 +1,50 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_PARTITION_H_INCLUDED
+#define HEADER_MODERN_UUID_PARTITION_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+#include <vector>
+
+namespace muuid {
+
+    /// A range of IDs produced by partition_by_time()
+    struct time_partition {
+        using time_point_t = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
+
+        /// Start of the time period. It is a multiple of the period length since Unix epoch.
+        time_point_t start;
+        /// Index of the first ID in the partition
+        size_t begin;
+        /// Index past the last ID in the partition
+        size_t end;
+    };
+
+    /**
+     * Groups IDs by time periods of their embedded timestamps
+     *
+     * Reorders `ids` so that IDs whose timestamps fall into the same `period` are contiguous and
+     * the groups go in the order of time. The order of IDs within a group is preserved. Periods are
+     * aligned to multiples of `period` since Unix epoch (so hourly periods start at whole hours UTC).
+     *
+     * `out` is cleared and receives one entry per non-empty period in ascending order.
+     * UUIDs other than version 7 have no timestamp. They are moved, in their original order, 
+     * after all the partitions, starting at `out.back().end` (or at 0 if `out` is empty).
+     *
+     * The operation is a counting sort taking O(n) time and n IDs of extra memory unless the 
+     * timestamps span many more periods than there are IDs. In that case it falls back to
+     * O(n log(n)) stable sort.
+     *
+     * `period` must be positive.
+     */
+    MUUID_EXPORTED void partition_by_time(std::span<uuid> ids, std::chrono::milliseconds period, 
+                                          std::vector<time_partition> & out);
+    /// Same as partition_by_time(std::span<uuid>, std::chrono::milliseconds, std::vector<time_partition> &) for ULIDs
+    MUUID_EXPORTED void partition_by_time(std::span<ulid> ids, std::chrono::milliseconds period, 
+                                          std::vector<time_partition> & out);
+}
+
+#endif
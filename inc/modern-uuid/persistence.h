@@ -0,0 +1,466 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_PERSISTENCE_H_INCLUDED
+#define HEADER_MODERN_UUID_PERSISTENCE_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+#if MUUID_MULTITHREADED
+    #include <algorithm>
+    #include <atomic>
+    #include <mutex>
+    #include <condition_variable>
+    #include <thread>
+    #include <vector>
+#endif
+
+#if MUUID_MULTITHREADED && defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    #include <coroutine>
+    #include <stdexcept>
+    #define MUUID_SUPPORTS_COROUTINES 1
+#endif
+
+namespace muuid {
+
+#if MUUID_MULTITHREADED
+
+    /**
+     * Clock persistence adapter that writes to another persistence asynchronously
+     *
+     * Wraps any uuid_clock_persistence or ulid_clock_persistence. ID generation only updates
+     * the latest state in memory. A background thread periodically writes that state,
+     * if it changed, to the wrapped persistence.
+     *
+     * Each periodic write stores the `when` field advanced by `margin`. After a crash the
+     * generator reloads a timestamp that is ahead of every ID issued before the crash so
+     * no IDs can repeat. If a generator is about to pass the last written timestamp
+     * (because writes are slower than `margin`) it waits for the next write to complete.
+     *
+     * The wrapped persistence is read once, in the constructor. Its lock() is only used around
+     * that read and the background writes, so it no longer synchronizes ID generation
+     * with other processes. Do not use this adapter in processes that fork without exec.
+     *
+     * The object must outlive its use by the library: remove it from the generator
+     * (and let threads that used it release it) before destroying it. Destruction stops the
+     * background thread and writes the exact final state.
+     */
+    template<class Data>
+    class write_behind_clock_persistence final : public generic_clock_persistence<Data> {
+    private:
+        using when_duration = typename Data::time_point_t::duration;
+
+        class per_thread_impl final : public generic_clock_persistence<Data>::per_thread {
+        public:
+            per_thread_impl(write_behind_clock_persistence & parent) noexcept: m_parent(parent) {}
+
+            void close() noexcept override
+                { delete this; }
+
+            void lock() override
+                { this->m_parent.m_mutex.lock(); }
+            void unlock() override
+                { this->m_parent.m_mutex.unlock(); }
+
+            bool load(Data & d) override {
+                if (!this->m_parent.m_have_data)
+                    return false;
+                d = this->m_parent.m_data;
+                return true;
+            }
+            void store(const Data & d) override
+                { this->m_parent.update(d); }
+        private:
+            write_behind_clock_persistence & m_parent;
+        };
+    public:
+        /**
+         * Constructs the adapter and loads the current state from `persistence`
+         *
+         * @param persistence the persistence to write to. It is add_ref-ed for the lifetime of this object.
+         * @param interval how often to write the state if it changed
+         * @param margin how far ahead of the latest state the written timestamp is.
+         * Must be greater than `interval` plus the typical duration of a write, otherwise ID generation
+         * will periodically wait for writes. If 0, twice the `interval` is used.
+         */
+        write_behind_clock_persistence(generic_clock_persistence<Data> & persistence,
+                                       std::chrono::milliseconds interval = std::chrono::seconds(1),
+                                       std::chrono::milliseconds margin = std::chrono::milliseconds(0)):
+            m_persistence(persistence),
+            m_interval(interval),
+            m_margin(std::chrono::ceil<when_duration>(margin.count() ? margin : 2 * interval)) {
+
+            auto & per_thread = this->m_persistence.get_for_current_thread();
+            struct closer {
+                typename generic_clock_persistence<Data>::per_thread & p;
+                ~closer() { p.close(); }
+            } close_on_exit{per_thread};
+            {
+                std::lock_guard guard{per_thread};
+                this->m_have_data = per_thread.load(this->m_data);
+            }
+            this->m_persistence.add_ref();
+            this->m_thread = std::thread([this]() { this->run(); });
+        }
+
+        ~write_behind_clock_persistence() noexcept {
+            {
+                std::lock_guard guard{this->m_mutex};
+                this->m_stopping = true;
+            }
+            this->m_cond.notify_all();
+            this->m_thread.join();
+            this->m_persistence.sub_ref();
+        }
+
+        write_behind_clock_persistence(const write_behind_clock_persistence &) = delete;
+        write_behind_clock_persistence & operator=(const write_behind_clock_persistence &) = delete;
+
+        /// Writes the latest state (if changed) without waiting for the next interval
+        void flush() {
+            {
+                std::lock_guard guard{this->m_mutex};
+                this->m_flush_requested = true;
+            }
+            this->m_cond.notify_all();
+        }
+
+        auto get_for_current_thread() -> typename generic_clock_persistence<Data>::per_thread & override
+            { return *new per_thread_impl(*this); }
+
+        void add_ref() noexcept override
+            { this->m_ref_count.fetch_add(1, std::memory_order_relaxed); }
+        void sub_ref() noexcept override
+            { this->m_ref_count.fetch_sub(1, std::memory_order_acq_rel); }
+
+        /// Current reference count. Useful to check whether the library still uses this object.
+        int ref_count() const noexcept
+            { return this->m_ref_count.load(std::memory_order_acquire); }
+
+    private:
+        //Called with m_mutex held
+        void update(const Data & d) {
+            this->m_data = d;
+            this->m_have_data = true;
+            this->m_dirty = true;
+            if (this->m_data.when < this->m_horizon)
+                return;
+            //We are about to issue IDs past what is safely persisted. Wait for the writer.
+            std::unique_lock lock{this->m_mutex, std::adopt_lock};
+            this->m_flush_requested = true;
+            this->m_cond.notify_all();
+            this->m_cond.wait(lock, [this]() {
+                return this->m_data.when < this->m_horizon || this->m_stopping;
+            });
+            lock.release();
+        }
+
+        void run() noexcept {
+            auto & per_thread = this->m_persistence.get_for_current_thread();
+
+            std::unique_lock lock{this->m_mutex};
+            for ( ; ; ) {
+                this->m_cond.wait_for(lock, this->m_interval, [this]() {
+                    return this->m_flush_requested || this->m_stopping;
+                });
+                if (this->m_stopping)
+                    break;
+                this->m_flush_requested = false;
+                if (!this->m_dirty)
+                    continue;
+                Data data = this->m_data;
+                data.when += this->m_margin;
+                this->m_dirty = false;
+                lock.unlock();
+                bool written = write(per_thread, data);
+                lock.lock();
+                if (written) {
+                    if (this->m_horizon < data.when)
+                        this->m_horizon = data.when;
+                    this->m_cond.notify_all();
+                } else {
+                    this->m_dirty = true;
+                }
+            }
+            if (this->m_have_data) {
+                //No more IDs will be issued so the exact state is safe
+                Data data = this->m_data;
+                lock.unlock();
+                write(per_thread, data);
+            }
+            per_thread.close();
+        }
+
+        static bool write(typename generic_clock_persistence<Data>::per_thread & per_thread, const Data & data) noexcept {
+        #if MUUID_USE_EXCEPTIONS
+            try {
+        #endif
+                std::lock_guard guard{per_thread};
+                per_thread.store(data);
+                return true;
+        #if MUUID_USE_EXCEPTIONS
+            } catch(...) {
+                //Keep the state dirty and retry on the next interval
+                return false;
+            }
+        #endif
+        }
+
+    private:
+        generic_clock_persistence<Data> & m_persistence;
+        const std::chrono::milliseconds m_interval;
+        const when_duration m_margin;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        Data m_data{};
+        typename Data::time_point_t m_horizon{};
+        bool m_have_data = false;
+        bool m_dirty = false;
+        bool m_flush_requested = false;
+        bool m_stopping = false;
+        std::atomic<int> m_ref_count{0};
+
+        std::thread m_thread;
+    };
+
+#endif
+
+#if MUUID_SUPPORTS_COROUTINES
+
+    namespace impl {
+        template<class Data, class Id, Id (*Generate)()>
+        class generate_awaitable;
+    }
+
+    /**
+     * Clock persistence with asynchronous writes for use from coroutines
+     *
+     * Derive from this class and implement start_store() to write clock state using
+     * asynchronous I/O (io_uring, an executor etc.). Then set the object as the persistence
+     * of a generator and generate IDs via `co_await` on async_generate_time_based(),
+     * async_generate_reordered_time_based(), async_generate_unix_time_based() or
+     * async_generate_ulid().
+     *
+     * Generation itself only updates the clock state in memory. Each write stores the `when` 
+     * field advanced by `margin`. An awaiting coroutine is suspended only if its ID is past 
+     * the last written timestamp. It is resumed once a write covering it completes. 
+     * Thus, with a large enough margin, writes happen roughly once per `margin` and almost 
+     * all generations complete without suspending.
+     *
+     * Generations that do not go through the `async_generate_` functions are not covered by this
+     * guarantee. The same usage restrictions as for write_behind_clock_persistence apply.
+     */
+    template<class Data>
+    class async_clock_persistence : public generic_clock_persistence<Data> {
+        template<class D, class Id, Id (*Generate)()>
+        friend class impl::generate_awaitable;
+    private:
+        using time_point_t = typename Data::time_point_t;
+
+        class per_thread_impl final : public generic_clock_persistence<Data>::per_thread {
+        public:
+            per_thread_impl(async_clock_persistence & parent) noexcept: m_parent(parent) {}
+
+            void close() noexcept override
+                { delete this; }
+
+            void lock() override
+                { this->m_parent.m_mutex.lock(); }
+            void unlock() override
+                { this->m_parent.m_mutex.unlock(); }
+
+            bool load(Data & d) override {
+                if (!this->m_parent.m_have_data)
+                    return false;
+                d = this->m_parent.m_data;
+                return true;
+            }
+            void store(const Data & d) override {
+                this->m_parent.m_data = d;
+                this->m_parent.m_have_data = true;
+                this->m_parent.m_dirty = true;
+                t_last_store = {&this->m_parent, d.when};
+            }
+        private:
+            async_clock_persistence & m_parent;
+        };
+
+        struct last_store {
+            const async_clock_persistence * owner;
+            time_point_t when;
+        };
+
+        struct waiter {
+            time_point_t when;
+            std::coroutine_handle<> handle;
+        };
+    public:
+        auto get_for_current_thread() -> typename generic_clock_persistence<Data>::per_thread & override
+            { return *new per_thread_impl(*this); }
+
+        void add_ref() noexcept override
+            { this->m_ref_count.fetch_add(1, std::memory_order_relaxed); }
+        void sub_ref() noexcept override
+            { this->m_ref_count.fetch_sub(1, std::memory_order_acq_rel); }
+
+        /// Current reference count. Useful to check whether the library still uses this object.
+        int ref_count() const noexcept
+            { return this->m_ref_count.load(std::memory_order_acquire); }
+
+    protected:
+        /**
+         * Constructs the object
+         * 
+         * @param initial the previously persisted state, if any. Load it asynchronously before constructing this object.
+         * @param margin how far ahead of the latest state the written timestamp is. Must be positive.
+         */
+        async_clock_persistence(const Data * initial, std::chrono::milliseconds margin):
+            m_margin(std::chrono::ceil<typename time_point_t::duration>(margin)) {
+            //A write must cover timestamps after the state it was made from, otherwise waiters never resume
+            if (margin.count() <= 0)
+                MUUID_THROW(std::invalid_argument("async_clock_persistence margin must be positive"));
+            if (initial) {
+                this->m_data = *initial;
+                this->m_have_data = true;
+            }
+        }
+        ~async_clock_persistence() noexcept = default;
+        async_clock_persistence(const async_clock_persistence &) = delete;
+        async_clock_persistence & operator=(const async_clock_persistence &) = delete;
+
+        /**
+         * Start writing the state
+         * 
+         * Call store_completed() when the write finishes. It can be called from any thread and
+         * even from inside this call. Only one write is outstanding at any time.
+         */
+        virtual void start_store(const Data & d) noexcept = 0;
+
+        /**
+         * Report completion of a write started by start_store()
+         * 
+         * Coroutines covered by the write are resumed from inside this call. 
+         * If the write failed another one is started immediately. To back off, delay calling this method.
+         */
+        void store_completed(bool success) noexcept {
+            std::vector<std::coroutine_handle<>> ready;
+            Data next;
+            bool start;
+            {
+                std::lock_guard guard{this->m_mutex};
+                this->m_in_flight = false;
+                if (success) {
+                    if (this->m_horizon < this->m_in_flight_when)
+                        this->m_horizon = this->m_in_flight_when;
+                    auto it = std::partition(this->m_waiters.begin(), this->m_waiters.end(), [this](const waiter & w) {
+                        return !(w.when < this->m_horizon);
+                    });
+                    for (auto cur = it; cur != this->m_waiters.end(); ++cur)
+                        ready.push_back(cur->handle);
+                    this->m_waiters.erase(it, this->m_waiters.end());
+                } else {
+                    this->m_dirty = true;
+                }
+                start = this->prepare_store(next);
+            }
+            for (auto handle: ready)
+                handle.resume();
+            if (start)
+                this->start_store(next);
+        }
+
+    private:
+        //Called with m_mutex held
+        bool prepare_store(Data & next) {
+            if (this->m_in_flight || !this->m_dirty || this->m_waiters.empty())
+                return false;
+            next = this->m_data;
+            next.when += this->m_margin;
+            this->m_in_flight = true;
+            this->m_in_flight_when = next.when;
+            this->m_dirty = false;
+            return true;
+        }
+
+        bool is_persisted(time_point_t when) {
+            std::lock_guard guard{this->m_mutex};
+            return when < this->m_horizon;
+        }
+
+        bool suspend(time_point_t when, std::coroutine_handle<> handle) {
+            Data next;
+            bool start;
+            {
+                std::lock_guard guard{this->m_mutex};
+                if (when < this->m_horizon)
+                    return false;
+                this->m_waiters.push_back({when, handle});
+                start = this->prepare_store(next);
+            }
+            if (start)
+                this->start_store(next);
+            return true;
+        }
+
+    private:
+        static inline thread_local last_store t_last_store{};
+
+        const typename time_point_t::duration m_margin;
+
+        std::mutex m_mutex;
+        Data m_data{};
+        time_point_t m_horizon{};
+        time_point_t m_in_flight_when{};
+        std::vector<waiter> m_waiters;
+        bool m_have_data = false;
+        bool m_dirty = false;
+        bool m_in_flight = false;
+        std::atomic<int> m_ref_count{0};
+    };
+
+    namespace impl {
+        template<class Data, class Id, Id (*Generate)()>
+        class generate_awaitable {
+        public:
+            generate_awaitable(async_clock_persistence<Data> & pers) noexcept: m_pers(pers) {}
+
+            bool await_ready() {
+                auto & last = async_clock_persistence<Data>::t_last_store;
+                last.owner = nullptr;
+                this->m_result = Generate();
+                if (last.owner != &this->m_pers)
+                    MUUID_THROW(std::logic_error("async_clock_persistence is not set for the generator"));
+                this->m_when = last.when;
+                return this->m_pers.is_persisted(this->m_when);
+            }
+            bool await_suspend(std::coroutine_handle<> handle) 
+                { return this->m_pers.suspend(this->m_when, handle); }
+            Id await_resume() const noexcept 
+                { return this->m_result; }
+        private:
+            async_clock_persistence<Data> & m_pers;
+            typename Data::time_point_t m_when;
+            Id m_result;
+        };
+    }
+
+    /// Awaitable uuid::generate_time_based(). `pers` must be set via set_time_based_persistence().
+    inline auto async_generate_time_based(async_clock_persistence<uuid_persistence_data> & pers) 
+        { return impl::generate_awaitable<uuid_persistence_data, uuid, uuid::generate_time_based>(pers); }
+    /// Awaitable uuid::generate_reordered_time_based(). `pers` must be set via set_reordered_time_based_persistence().
+    inline auto async_generate_reordered_time_based(async_clock_persistence<uuid_persistence_data> & pers) 
+        { return impl::generate_awaitable<uuid_persistence_data, uuid, uuid::generate_reordered_time_based>(pers); }
+    /// Awaitable uuid::generate_unix_time_based(). `pers` must be set via set_unix_time_based_persistence().
+    inline auto async_generate_unix_time_based(async_clock_persistence<uuid_persistence_data> & pers) 
+        { return impl::generate_awaitable<uuid_persistence_data, uuid, uuid::generate_unix_time_based>(pers); }
+    /// Awaitable ulid::generate(). `pers` must be set via set_ulid_persistence().
+    inline auto async_generate_ulid(async_clock_persistence<ulid_persistence_data> & pers) 
+        { return impl::generate_awaitable<ulid_persistence_data, ulid, ulid::generate>(pers); }
+
+#endif
+
+}
+
+#endif
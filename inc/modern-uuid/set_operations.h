@@ -0,0 +1,57 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_SET_OPERATIONS_H_INCLUDED
+#define HEADER_MODERN_UUID_SET_OPERATIONS_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+namespace muuid {
+
+    /**
+     * Computes intersection of two sorted ranges of UUIDs
+     *
+     * The result is the same as of `std::set_intersection` with the default ordering of UUIDs, 
+     * including handling of duplicates, but is computed much faster. Long runs of non-matching IDs 
+     * are skipped using galloping search and shorter ones via SIMD comparisons of blocks of IDs.
+     *
+     * `dest` must have room for `std::min(lhs.size(), rhs.size())` elements and must not overlap the 
+     * inputs. Otherwise std::invalid_argument is thrown.
+     *
+     * @return number of elements written to `dest`
+     */
+    MUUID_EXPORTED auto set_intersection(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t;
+    /**
+     * Computes difference of two sorted ranges of UUIDs
+     *
+     * Produces the same result as `std::set_difference`: the elements of `lhs` not found in `rhs`. 
+     * See set_intersection() for details.
+     *
+     * `dest` must have room for `lhs.size()` elements and must not overlap the inputs. 
+     * Otherwise std::invalid_argument is thrown.
+     *
+     * @return number of elements written to `dest`
+     */
+    MUUID_EXPORTED auto set_difference(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t;
+    /**
+     * Computes union of two sorted ranges of UUIDs
+     *
+     * Produces the same result as `std::set_union`. See set_intersection() for details.
+     *
+     * `dest` must have room for `lhs.size() + rhs.size()` elements and must not overlap the inputs. 
+     * Otherwise std::invalid_argument is thrown.
+     *
+     * @return number of elements written to `dest`
+     */
+    MUUID_EXPORTED auto set_union(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t;
+
+    /// Same as set_intersection(std::span<const uuid>, std::span<const uuid>, std::span<uuid>) for ULIDs
+    MUUID_EXPORTED auto set_intersection(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t;
+    /// Same as set_difference(std::span<const uuid>, std::span<const uuid>, std::span<uuid>) for ULIDs
+    MUUID_EXPORTED auto set_difference(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t;
+    /// Same as set_union(std::span<const uuid>, std::span<const uuid>, std::span<uuid>) for ULIDs
+    MUUID_EXPORTED auto set_union(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t;
+}
+
+#endif
@@ -0,0 +1,223 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_SHARDING_H_INCLUDED
+#define HEADER_MODERN_UUID_SHARDING_H_INCLUDED
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+
+#include <bit>
+#include <limits>
+#include <ranges>
+
+namespace muuid {
+
+    namespace impl {
+
+        /// SplitMix64 finalizer. A bijection on 64-bit values with full avalanche.
+        constexpr uint64_t shard_mix(uint64_t val) noexcept {
+            val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9;
+            val = (val ^ (val >> 27)) * 0x94d049bb133111eb;
+            return val ^ (val >> 31);
+        }
+
+        /**
+         * Returns 64-bit placement key of an ID
+         *
+         * The bytes are read as little-endian 64-bit words (the last one zero-padded) so the
+         * result does not depend on the platform. Only random and name-based UUIDs, whose folded 
+         * 64 bits are all uniform, are simply folded while all others are fully mixed. 
+         * This is stricter than hash_traits: packed NanoIDs and Cuid2s hash well but their high
+         * bits are not uniform which would bias comparisons of the key against a threshold.
+         */
+        template<id_type T>
+        constexpr uint64_t shard_key(const T & val) noexcept {
+            constexpr size_t size = std::tuple_size_v<decltype(T::bytes)>;
+            bool uniform = false;
+            if constexpr (std::is_same_v<T, uuid>)
+                uniform = hash_traits<T>::uniform(val);
+            uint64_t ret = 0;
+            for (size_t i = 0; i < size; i += 8) {
+                uint64_t word = 0;
+                for (size_t j = std::min(size - i, size_t(8)); j > 0; --j)
+                    word = (word << 8) | val.bytes[i + j - 1];
+                ret = uniform ? ret ^ word : shard_mix(ret ^ word);
+            }
+            return ret;
+        }
+
+        /**
+         * Jump consistent hash by Lamping and Veach
+         *
+         * The intermediate value is clamped to `count` before conversion so that it
+         * never overflows. This doesn't change the result.
+         */
+        constexpr uint32_t jump_hash(uint64_t key, uint32_t count) noexcept {
+            uint32_t ret = 0;
+            double next = 0;
+            while (next < double(count)) {
+                ret = uint32_t(next);
+                key = key * 2862933555777941757 + 1;
+                next = double(ret + uint64_t(1)) * (double(uint64_t(1) << 31) / double((key >> 33) + 1));
+            }
+            return ret;
+        }
+
+        constexpr uint64_t rendezvous_score(uint64_t key, uint64_t mixed_shard) noexcept
+            { return shard_mix(key ^ mixed_shard); }
+
+        /// Placement keys less than this are sampled at the given rate
+        constexpr uint64_t sample_threshold(double rate) noexcept {
+            if (!(rate > 0))
+                return 0;
+            if (rate >= 1)
+                return std::numeric_limits<uint64_t>::max();
+            return uint64_t(rate * 18446744073709551616.0); //2^64
+        }
+
+        MUUID_EXPORTED void shard_keys_bulk(const uuid * src, uint64_t * dest, size_t size) noexcept;
+        MUUID_EXPORTED void shard_keys_bulk(const ulid * src, uint64_t * dest, size_t size) noexcept;
+        MUUID_EXPORTED void jump_hash_bulk(const uint64_t * keys, uint32_t count, uint32_t * dest, size_t size) noexcept;
+        MUUID_EXPORTED void rendezvous_bulk(const uint64_t * keys, const uint64_t * shards, size_t shard_count,
+                                            uint32_t * dest, size_t size) noexcept;
+
+        template<class R>
+        concept id_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                           id_type<std::ranges::range_value_t<R>>;
+
+        /// Computes shard_key() for multiple IDs. UUIDs and ULIDs use SIMD kernels.
+        template<id_type T>
+        void shard_keys(const T * src, uint64_t * dest, size_t size) noexcept {
+            if constexpr (std::is_same_v<T, uuid> || std::is_same_v<T, ulid>) {
+                shard_keys_bulk(src, dest, size);
+            } else {
+                for (size_t i = 0; i < size; ++i)
+                    dest[i] = shard_key(src[i]);
+            }
+        }
+
+        /// Computes placement keys of `size` IDs in fixed size chunks on the stack and passes them to `func`
+        template<id_range R, class Func>
+        void for_each_shard_key_chunk(R && ids, size_t size, Func func) noexcept {
+            constexpr size_t chunk = 256;
+            uint64_t keys[chunk];
+            auto src = std::ranges::data(ids);
+            for (size_t i = 0; i < size; i += chunk) {
+                const size_t count = std::min(size - i, chunk);
+                shard_keys(src + i, keys, count);
+                func(keys, i, count);
+            }
+        }
+    }
+
+    /**
+     * Returns whether an ID is in a consistent sample of the given rate
+     *
+     * An ID is sampled if its 64-bit placement key (see shard_of()) is less than `rate * 2^64`.
+     * The decision depends only on the ID and the rate so all services sampling the same rate 
+     * make the same decision and IDs sampled at a lower rate are also sampled at any higher one. 
+     * 
+     * `rate` is clamped to `[0, 1]`.
+     */
+    template<impl::id_type T>
+    constexpr bool sampled(const T & id, double rate) noexcept
+        { return impl::shard_key(id) < impl::sample_threshold(rate); }
+
+    /**
+     * Computes sampled() for multiple IDs
+     *
+     * The results are written as a bitmask: bit `i % 64` of `dest[i / 64]` is set if `ids[i]` is sampled.
+     * Processes `std::min(std::size(ids), dest.size() * 64)` elements. Unused bits of the last 
+     * word written are cleared.
+     * 
+     * @return number of sampled IDs
+     */
+    template<impl::id_range R>
+    size_t sampled(R && ids, double rate, std::span<uint64_t> dest) noexcept {
+        const uint64_t threshold = impl::sample_threshold(rate);
+        const size_t size = std::min(std::ranges::size(ids), dest.size() * 64);
+        size_t ret = 0;
+        impl::for_each_shard_key_chunk(ids, size, [&](const uint64_t * keys, size_t offset, size_t count) {
+            for (size_t i = 0; i < count; i += 64) {
+                uint64_t word = 0;
+                for (size_t j = 0; j < std::min(count - i, size_t(64)); ++j)
+                    word |= uint64_t(keys[i + j] < threshold) << j;
+                dest[(offset + i) / 64] = word;
+                ret += size_t(std::popcount(word));
+            }
+        });
+        return ret;
+    }
+
+    /**
+     * Returns the shard, in range `[0, count)`, an ID belongs to
+     *
+     * Uses jump consistent hashing: when `count` grows by one only about `1/count` of IDs
+     * move and all of them move to the new shard. Shards can only be added or removed
+     * at the end of the range. Use rendezvous_shard_of() if arbitrary shards can go away.
+     *
+     * Random and name-based UUIDs are used directly while all other IDs are mixed first. 
+     * The result is the same on all platforms.
+     *
+     * `count` must be greater than 0.
+     */
+    template<impl::id_type T>
+    constexpr uint32_t shard_of(const T & id, uint32_t count) noexcept
+        { return impl::jump_hash(impl::shard_key(id), count); }
+
+    /**
+     * Computes shard_of() for multiple IDs
+     *
+     * Processes `std::min(std::size(ids), dest.size())` elements. Multiple IDs are processed
+     * at a time using SIMD instructions where available.
+     */
+    template<impl::id_range R>
+    void shard_of(R && ids, uint32_t count, std::span<uint32_t> dest) noexcept {
+        const size_t size = std::min(std::ranges::size(ids), dest.size());
+        impl::for_each_shard_key_chunk(ids, size, [&](const uint64_t * keys, size_t offset, size_t chunk) {
+            impl::jump_hash_bulk(keys, count, dest.data() + offset, chunk);
+        });
+    }
+
+    /**
+     * Returns index of the shard in `shards` an ID belongs to
+     *
+     * Uses rendezvous (highest random weight) hashing: each shard is identified by an arbitrary
+     * 64-bit value and the ID goes to the shard with the highest score. Removing a shard only moves
+     * IDs that belonged to it and adding one only moves IDs to it, no matter the position in `shards`.
+     * The cost is linear in the number of shards.
+     *
+     * `shards` must not be empty and should not contain duplicates.
+     */
+    template<impl::id_type T>
+    constexpr uint32_t rendezvous_shard_of(const T & id, std::span<const uint64_t> shards) noexcept {
+        const uint64_t key = impl::shard_key(id);
+        uint32_t ret = 0;
+        uint64_t best = 0;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            uint64_t score = impl::rendezvous_score(key, impl::shard_mix(shards[i]));
+            if (i == 0 || score > best) {
+                best = score;
+                ret = uint32_t(i);
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * Computes rendezvous_shard_of() for multiple IDs
+     *
+     * Processes `std::min(std::size(ids), dest.size())` elements. Multiple IDs are processed
+     * at a time using SIMD instructions where available.
+     */
+    template<impl::id_range R>
+    void rendezvous_shard_of(R && ids, std::span<const uint64_t> shards, std::span<uint32_t> dest) noexcept {
+        const size_t size = std::min(std::ranges::size(ids), dest.size());
+        impl::for_each_shard_key_chunk(ids, size, [&](const uint64_t * keys, size_t offset, size_t chunk) {
+            impl::rendezvous_bulk(keys, shards.data(), shards.size(), dest.data() + offset, chunk);
+        });
+    }
+}
+
+#endif
@@ -208,6 +208,68 @@ namespace muuid {
         /// Generates a ULID
         MUUID_EXPORTED static auto generate() -> ulid;
 
+        /**
+         * Generates ULIDs into an array of records
+         * 
+         * Writes `count` ULIDs to `dest`, `dest + stride`, `dest + 2 * stride` etc. where `stride`
+         * is in bytes. The results are the same as from calling generate() `count` times but 
+         * the clock state is acquired (and persisted) once per batch of IDs.
+         */
+        MUUID_EXPORTED static void generate_into(void * dest, size_t stride, size_t count);
+
+        /**
+         * Generates ULIDs into elements of a range or their fields
+         * 
+         * For example `ulid::generate_into(rows, &row::id)`. When the range is contiguous and 
+         * the projection is a data member pointer the ULIDs are written directly to each field.
+         */
+        template<class R, class Proj = std::identity>
+        requires(impl::projectable_range<R, Proj, ulid>)
+        static void generate_into(R && records, Proj proj = {}) {
+            impl::generate_projected<ulid>(records, proj, [](void * dest, size_t stride, size_t count) {
+                ulid::generate_into(dest, stride, count);
+            });
+        }
+
+        /**
+         * Generates a ULID without intra-millisecond monotonicity
+         * 
+         * The result is the current time followed by 80 random bits. Unlike generate() this 
+         * does not use any clock state or persistence and ULIDs generated within the same 
+         * millisecond are not ordered.
+         */
+        MUUID_EXPORTED static auto generate_unordered() -> ulid;
+
+        /**
+         * Fills the destination with ULIDs generated as if by generate_unordered()
+         * 
+         * The clock is read only once so all ULIDs share the same timestamp.
+         */
+        MUUID_EXPORTED static void generate_unordered(std::span<ulid> dest);
+
+        /**
+         * Generates ULIDs as if by generate_unordered() into an array of records
+         * 
+         * Writes `count` ULIDs to `dest`, `dest + stride`, `dest + 2 * stride` etc. where `stride`
+         * is in bytes. The clock is read only once so all ULIDs share the same timestamp.
+         */
+        MUUID_EXPORTED static void generate_unordered_into(void * dest, size_t stride, size_t count);
+
+        /**
+         * Generates ULIDs as if by generate_unordered() into elements of a range or their fields
+         * 
+         * For example `ulid::generate_unordered_into(rows, &row::id)`. When the range is contiguous and 
+         * the projection is a data member pointer the ULIDs are written directly to each field 
+         * and share the same timestamp.
+         */
+        template<class R, class Proj = std::identity>
+        requires(impl::projectable_range<R, Proj, ulid>)
+        static void generate_unordered_into(R && records, Proj proj = {}) {
+            impl::generate_projected<ulid>(records, proj, [](void * dest, size_t stride, size_t count) {
+                ulid::generate_unordered_into(dest, stride, count);
+            });
+        }
+
         /// Returns a Max ULID
         static constexpr ulid max() noexcept 
             { return ulid("7ZZZZZZZZZZZZZZZZZZZZZZZZZ"); }
@@ -448,6 +510,17 @@ namespace muuid {
      */
     MUUID_EXPORTED void set_ulid_persistence(ulid_clock_persistence * persistence);
 
+    /**
+     * Advance the local clock for ulid::generate() and uuid::generate_unix_time_based() past 
+     * the timestamp of a ULID received from elsewhere.
+     * 
+     * See observe(const uuid &, std::chrono::milliseconds) for details.
+     * 
+     * @return whether the ULID was accepted
+     */
+    MUUID_EXPORTED bool observe(const ulid & id, 
+                                std::chrono::milliseconds max_skew = std::chrono::minutes(1)) noexcept;
+
 }
 
 #endif
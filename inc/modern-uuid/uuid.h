@@ -302,6 +302,52 @@ namespace muuid {
         /// Generates a version 7 UUID
         MUUID_EXPORTED static auto generate_unix_time_based() -> uuid;
 
+        /**
+         * Generates version 4 UUIDs into an array of records
+         * 
+         * Writes `count` UUIDs to `dest`, `dest + stride`, `dest + 2 * stride` etc. where `stride`
+         * is in bytes. Use this to fill a UUID field of each element of an array of structs without 
+         * a temporary buffer. The random bits are copied from the generator keystream a block at a time.
+         */
+        MUUID_EXPORTED static void generate_random_into(void * dest, size_t stride, size_t count) noexcept;
+
+        /**
+         * Generates version 4 UUIDs into elements of a range or their fields
+         * 
+         * For example `uuid::generate_random_into(rows, &row::id)`. When the range is contiguous and 
+         * the projection is a data member pointer the UUIDs are written directly to each field.
+         */
+        template<class R, class Proj = std::identity>
+        requires(impl::projectable_range<R, Proj, uuid>)
+        static void generate_random_into(R && records, Proj proj = {}) {
+            impl::generate_projected<uuid>(records, proj, [](void * dest, size_t stride, size_t count) {
+                uuid::generate_random_into(dest, stride, count);
+            });
+        }
+
+        /**
+         * Generates version 7 UUIDs into an array of records
+         * 
+         * Writes `count` UUIDs to `dest`, `dest + stride`, `dest + 2 * stride` etc. where `stride`
+         * is in bytes. The results are the same as from calling generate_unix_time_based() `count` 
+         * times but the clock state is acquired (and persisted) once per batch of IDs.
+         */
+        MUUID_EXPORTED static void generate_unix_time_based_into(void * dest, size_t stride, size_t count);
+
+        /**
+         * Generates version 7 UUIDs into elements of a range or their fields
+         * 
+         * For example `uuid::generate_unix_time_based_into(rows, &row::id)`. When the range is contiguous and 
+         * the projection is a data member pointer the UUIDs are written directly to each field.
+         */
+        template<class R, class Proj = std::identity>
+        requires(impl::projectable_range<R, Proj, uuid>)
+        static void generate_unix_time_based_into(R && records, Proj proj = {}) {
+            impl::generate_projected<uuid>(records, proj, [](void * dest, size_t stride, size_t count) {
+                uuid::generate_unix_time_based_into(dest, stride, count);
+            });
+        }
+
         /// Returns a Max UUID
         static constexpr uuid max() noexcept 
             { return uuid("FFFFFFFF-FFFF-FFFF-FFFF-FFFFFFFFFFFF"); }
@@ -550,6 +596,18 @@ namespace muuid {
     };
 
     namespace impl {
+        template<>
+        struct hash_traits<uuid> {
+            static constexpr bool uniform(const uuid & val) noexcept {
+                if (val.get_variant() != uuid::variant::standard)
+                    return false;
+                auto type = val.get_type();
+                return type == uuid::type::random || 
+                       type == uuid::type::name_based_md5 || 
+                       type == uuid::type::name_based_sha1;
+            }
+        };
+
         template<class Derived, class CharT>
         struct formatter_base
         {
@@ -667,6 +725,78 @@ namespace muuid {
      * Pass `nullptr` to remove.
      */
     MUUID_EXPORTED void set_unix_time_based_persistence(uuid_clock_persistence * persistence);
+
+    /// Layout of the bits following the timestamp in UUIDs generated by uuid::generate_unix_time_based()
+    enum class unix_time_based_layout {
+        /// `rand_a` holds sub-millisecond clock fraction followed by a 14-bit counter in `rand_b` (default)
+        sub_millisecond,
+        /** 
+         * `rand_a` and the first 30 bits of `rand_b` hold a 42-bit counter randomly re-seeded each millisecond
+         * 
+         * This allows generating trillions of UUIDs per millisecond on a thread without waiting for the clock
+         */
+        counter
+    };
+
+    /**
+     * Set the layout of UUIDs generated by uuid::generate_unix_time_based()
+     * 
+     * The layout is a process-wide setting, like the persistence and clock borrow ones. 
+     * This call affects all subsequent calls to uuid::generate_unix_time_based() and its bulk 
+     * forms on all threads. After a change each thread continues after the last UUID it generated
+     * with the previous layout so the UUIDs it generates remain monotonic. 
+     * Note that persistence data produced by one layout is not meaningful for the other.
+     */
+    MUUID_EXPORTED void set_unix_time_based_layout(unix_time_based_layout layout) noexcept;
+
+    /// Statistics of system clock regressions seen by a time-based UUID generator
+    struct uuid_clock_statistics {
+        /// Number of times the system clock was observed going backwards
+        uint64_t regressions;
+        /// Number of regressions that exceeded the maximum borrow and caused a reset
+        uint64_t resets;
+        /// The largest distance the generated timestamps ran ahead of the clock during the most recent regression
+        std::chrono::nanoseconds last_borrow;
+        /// The largest distance the generated timestamps ran ahead of the clock during any regression
+        std::chrono::nanoseconds max_borrow;
+    };
+
+    /**
+     * Set the maximum clock borrow for uuid::generate_reordered_time_based()
+     * 
+     * When the system clock goes backwards by no more than `max_borrow` the generator keeps
+     * producing monotonically increasing UUIDs from the last used timestamp until the clock catches up.
+     * Larger regressions (and all regressions if `max_borrow` is 0, which is the default) re-initialize 
+     * the generator from the current clock reading, losing monotonicity.
+     */
+    MUUID_EXPORTED void set_reordered_time_based_max_clock_borrow(std::chrono::nanoseconds max_borrow) noexcept;
+    /**
+     * Set the maximum clock borrow for uuid::generate_unix_time_based()
+     * 
+     * See set_reordered_time_based_max_clock_borrow() for details.
+     */
+    MUUID_EXPORTED void set_unix_time_based_max_clock_borrow(std::chrono::nanoseconds max_borrow) noexcept;
+
+    /// Retrieve clock regression statistics for uuid::generate_reordered_time_based()
+    MUUID_EXPORTED auto get_reordered_time_based_clock_statistics() noexcept -> uuid_clock_statistics;
+    /// Retrieve clock regression statistics for uuid::generate_unix_time_based()
+    MUUID_EXPORTED auto get_unix_time_based_clock_statistics() noexcept -> uuid_clock_statistics;
+
+    /**
+     * Advance the local clock for uuid::generate_unix_time_based() and ulid::generate() past 
+     * the timestamp of a UUID received from elsewhere.
+     * 
+     * This implements a hybrid logical clock: after this call returns `true` every ID generated
+     * locally (by any thread) sorts after `id` even if the local system clock lags behind the
+     * clock of the host that produced it. Once the local clock catches up it is used as usual.
+     * 
+     * Only variant::standard type::unix_time_based UUIDs are accepted. Timestamps more than 
+     * `max_skew` ahead of the local clock are ignored to protect against garbage or malicious input.
+     * 
+     * @return whether the UUID was accepted
+     */
+    MUUID_EXPORTED bool observe(const uuid & id, 
+                                std::chrono::milliseconds max_skew = std::chrono::minutes(1)) noexcept;
 }
 
 
@@ -0,0 +1,306 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <modern-uuid/atomic_id.h>
+
+#include "cpu_dispatch.h"
+
+#include <thread>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #if defined(_M_X64)
+        #include <intrin.h>
+        #define MUUID_ATOMIC_ID_X64 1
+    #elif defined(_M_ARM64) || defined(_M_ARM64EC)
+        #include <intrin.h>
+        #define MUUID_ATOMIC_ID_ARM64 1
+    #endif
+#elif defined(__clang__) || defined(__GNUC__)
+    #if defined(__x86_64__)
+        #include <emmintrin.h>
+        #include <cpuid.h>
+        #define MUUID_ATOMIC_ID_X64 1
+    #elif defined(__aarch64__)
+        #define MUUID_ATOMIC_ID_ARM64 1
+    #endif
+#endif
+
+using namespace muuid;
+using namespace muuid::impl;
+
+namespace {
+
+    enum class atomic_mode {
+        //Writers are serialized via the sequence counter and readers retry on concurrent writes
+        seqlock,
+        //All operations use 16-byte compare-and-swap. Loads write the cache line so concurrent readers 
+        //contend with each other.
+        cas,
+        //As above but loads and stores use plain 16-byte moves which are atomic on x64 CPUs with AVX
+        cas_plain_moves
+    };
+
+    struct alignas(16) word_pair {
+        uint64_t words[2];
+    };
+
+    //16-byte instructions access atomic_id_storage::words as a plain pair of words
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free);
+    static_assert(sizeof(atomic_id_storage::words) == sizeof(word_pair));
+
+    inline word_pair * pair_of(const atomic_id_storage & storage) noexcept {
+        return reinterpret_cast<word_pair *>(const_cast<std::atomic<uint64_t> *>(storage.words));
+    }
+
+#if MUUID_ATOMIC_ID_X64
+
+    atomic_mode detect_mode() noexcept {
+        //CPUID.01H:ECX[13] is CMPXCHG16B and CPUID.01H:ECX[28] is AVX
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 1);
+        const unsigned ecx = unsigned(regs[2]);
+    #else
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return atomic_mode::seqlock;
+    #endif
+        const auto tier = max_cpu_tier();
+        if (!(ecx & (1u << 13)) || tier == cpu_tier::generic)
+            return atomic_mode::seqlock;
+        if ((ecx & (1u << 28)) && tier >= cpu_tier::avx2)
+            return atomic_mode::cas_plain_moves;
+        return atomic_mode::cas;
+    }
+
+    //On failure stores the current value in expected
+    inline bool compare_exchange_16(word_pair * dest, uint64_t (&expected)[2], const uint64_t (&desired)[2]) noexcept {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _InterlockedCompareExchange128(reinterpret_cast<volatile long long *>(dest->words),
+                                              (long long)desired[1], (long long)desired[0],
+                                              reinterpret_cast<long long *>(expected));
+    #else
+        bool ret;
+        asm volatile("lock cmpxchg16b %1"
+                     : "=@ccz"(ret), "+m"(*dest), "+a"(expected[0]), "+d"(expected[1])
+                     : "b"(desired[0]), "c"(desired[1])
+                     : "memory");
+        return ret;
+    #endif
+    }
+
+    inline void load_16(const word_pair * src, uint64_t (&dest)[2]) noexcept {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        __m128i val = _mm_load_si128(reinterpret_cast<const __m128i *>(src));
+    #else
+        __m128i val;
+        asm volatile("movdqa %1, %0" : "=x"(val) : "m"(*src) : "memory");
+    #endif
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), val);
+    }
+
+    inline void store_16(word_pair * dest, const uint64_t (&val)[2]) noexcept {
+        __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i *>(val));
+    #if defined(_MSC_VER) && !defined(__clang__)
+        _mm_store_si128(reinterpret_cast<__m128i *>(dest), src);
+        _mm_mfence();
+    #else
+        asm volatile("movdqa %1, %0\n\tmfence" : "=m"(*dest) : "x"(src) : "memory");
+    #endif
+    }
+
+#elif MUUID_ATOMIC_ID_ARM64
+
+    atomic_mode detect_mode() noexcept {
+        //Exclusive pair instructions are available on all ARM64 CPUs
+        return atomic_mode::cas;
+    }
+
+    //On failure stores the current value in expected
+    inline bool compare_exchange_16(word_pair * dest, uint64_t (&expected)[2], const uint64_t (&desired)[2]) noexcept {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        return _InterlockedCompareExchange128(reinterpret_cast<volatile long long *>(dest->words),
+                                              (long long)desired[1], (long long)desired[0],
+                                              reinterpret_cast<long long *>(expected));
+    #elif defined(__ARM_FEATURE_ATOMICS)
+        //casp requires even/odd register pairs
+        register uint64_t current_low asm("x0") = expected[0];
+        register uint64_t current_high asm("x1") = expected[1];
+        register uint64_t desired_low asm("x2") = desired[0];
+        register uint64_t desired_high asm("x3") = desired[1];
+        asm volatile("caspal %0, %1, %3, %4, %2"
+                     : "+r"(current_low), "+r"(current_high), "+Q"(*dest)
+                     : "r"(desired_low), "r"(desired_high)
+                     : "memory");
+        const bool ret = current_low == expected[0] && current_high == expected[1];
+        expected[0] = current_low;
+        expected[1] = current_high;
+        return ret;
+    #else
+        //Store back the current value if it doesn't match. This is needed to know the pair was read atomically.
+        uint64_t current_low, current_high, new_low, new_high;
+        uint32_t failed;
+        asm volatile("1: ldaxp %[cur_low], %[cur_high], %[mem]\n"
+                     "   cmp %[cur_low], %[exp_low]\n"
+                     "   ccmp %[cur_high], %[exp_high], #0, eq\n"
+                     "   csel %[new_low], %[des_low], %[cur_low], eq\n"
+                     "   csel %[new_high], %[des_high], %[cur_high], eq\n"
+                     "   stlxp %w[failed], %[new_low], %[new_high], %[mem]\n"
+                     "   cbnz %w[failed], 1b"
+                     : [cur_low]"=&r"(current_low), [cur_high]"=&r"(current_high),
+                       [new_low]"=&r"(new_low), [new_high]"=&r"(new_high), [failed]"=&r"(failed), [mem]"+Q"(*dest)
+                     : [exp_low]"r"(expected[0]), [exp_high]"r"(expected[1]),
+                       [des_low]"r"(desired[0]), [des_high]"r"(desired[1])
+                     : "cc", "memory");
+        const bool ret = current_low == expected[0] && current_high == expected[1];
+        expected[0] = current_low;
+        expected[1] = current_high;
+        return ret;
+    #endif
+    }
+
+    //Never used: ARM64 has no plain 16-byte moves that are atomic on all CPUs
+    inline void load_16(const word_pair *, uint64_t (&)[2]) noexcept {}
+    inline void store_16(word_pair *, const uint64_t (&)[2]) noexcept {}
+
+#else
+
+    atomic_mode detect_mode() noexcept {
+        return atomic_mode::seqlock;
+    }
+
+    inline bool compare_exchange_16(word_pair *, uint64_t (&)[2], const uint64_t (&)[2]) noexcept { return false; }
+    inline void load_16(const word_pair *, uint64_t (&)[2]) noexcept {}
+    inline void store_16(word_pair *, const uint64_t (&)[2]) noexcept {}
+
+#endif
+
+    atomic_mode get_mode() noexcept {
+        static const atomic_mode ret = detect_mode();
+        return ret;
+    }
+
+    //Acquires the seqlock for writing. Returns the (even) sequence value before acquisition.
+    uint64_t write_lock(atomic_id_storage & storage) noexcept {
+        for (unsigned spins = 0; ; ++spins) {
+            uint64_t current = storage.sequence.load(std::memory_order_relaxed);
+            if (!(current & 1) &&
+                storage.sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                std::atomic_thread_fence(std::memory_order_release);
+                return current;
+            }
+            //Writers hold the lock for a few instructions. If it is still held the holder was preempted.
+            if (spins < 100) {
+            #ifdef MUUID_THREAD_YIELD
+                MUUID_THREAD_YIELD;
+            #endif
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void write_unlock(atomic_id_storage & storage, uint64_t sequence) noexcept {
+        storage.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void seqlock_read(const atomic_id_storage & storage, uint64_t (&dest)[2]) noexcept {
+        for ( ; ; ) {
+            uint64_t before = storage.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+            #ifdef MUUID_THREAD_YIELD
+                MUUID_THREAD_YIELD;
+            #endif
+                continue;
+            }
+            dest[0] = storage.words[0].load(std::memory_order_relaxed);
+            dest[1] = storage.words[1].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (storage.sequence.load(std::memory_order_relaxed) == before)
+                return;
+        }
+    }
+
+    void seqlock_write(atomic_id_storage & storage, const uint64_t (&val)[2]) noexcept {
+        storage.words[0].store(val[0], std::memory_order_relaxed);
+        storage.words[1].store(val[1], std::memory_order_relaxed);
+    }
+}
+
+bool muuid::impl::atomic_id_is_lock_free() noexcept {
+    return get_mode() != atomic_mode::seqlock;
+}
+
+void muuid::impl::atomic_id_load(const atomic_id_storage & storage, uint64_t (&dest)[2]) noexcept {
+    switch (get_mode()) {
+    case atomic_mode::cas_plain_moves:
+        load_16(pair_of(storage), dest);
+        break;
+    case atomic_mode::cas: {
+        //Replaces the value with itself if it happens to be 0
+        const uint64_t zero[2] = {0, 0};
+        dest[0] = dest[1] = 0;
+        compare_exchange_16(pair_of(storage), dest, zero);
+        break;
+    }
+    case atomic_mode::seqlock:
+        seqlock_read(storage, dest);
+        break;
+    }
+}
+
+void muuid::impl::atomic_id_store(atomic_id_storage & storage, const uint64_t (&val)[2]) noexcept {
+    switch (get_mode()) {
+    case atomic_mode::cas_plain_moves:
+        store_16(pair_of(storage), val);
+        break;
+    case atomic_mode::cas: {
+        uint64_t old[2];
+        atomic_id_exchange(storage, val, old);
+        break;
+    }
+    case atomic_mode::seqlock: {
+        auto sequence = write_lock(storage);
+        seqlock_write(storage, val);
+        write_unlock(storage, sequence);
+        break;
+    }
+    }
+}
+
+void muuid::impl::atomic_id_exchange(atomic_id_storage & storage, const uint64_t (&val)[2], uint64_t (&old)[2]) noexcept {
+    if (get_mode() == atomic_mode::seqlock) {
+        auto sequence = write_lock(storage);
+        old[0] = storage.words[0].load(std::memory_order_relaxed);
+        old[1] = storage.words[1].load(std::memory_order_relaxed);
+        seqlock_write(storage, val);
+        write_unlock(storage, sequence);
+        return;
+    }
+    //The initial guess doesn't need to be consistent. A failed attempt gives us the current value.
+    old[0] = storage.words[0].load(std::memory_order_relaxed);
+    old[1] = storage.words[1].load(std::memory_order_relaxed);
+    while (!compare_exchange_16(pair_of(storage), old, val))
+        ;
+}
+
+bool muuid::impl::atomic_id_compare_exchange(atomic_id_storage & storage,
+                                             uint64_t (&expected)[2], const uint64_t (&desired)[2]) noexcept {
+    if (get_mode() == atomic_mode::seqlock) {
+        auto sequence = write_lock(storage);
+        uint64_t current[2] = {
+            storage.words[0].load(std::memory_order_relaxed),
+            storage.words[1].load(std::memory_order_relaxed)
+        };
+        const bool ret = current[0] == expected[0] && current[1] == expected[1];
+        if (ret) {
+            seqlock_write(storage, desired);
+        } else {
+            expected[0] = current[0];
+            expected[1] = current[1];
+        }
+        write_unlock(storage, sequence);
+        return ret;
+    }
+    return compare_exchange_16(pair_of(storage), expected, desired);
+}
@@ -0,0 +1,39 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <modern-uuid/cipher.h>
+
+#include "cipher_kernels_impl.h"
+
+using namespace muuid;
+using namespace muuid::impl;
+
+const cipher_kernels muuid::impl::cipher_kernels_baseline = make_cipher_kernels();
+
+auto muuid::impl::get_cipher_kernels() noexcept -> const kernel_variant<cipher_kernels> & {
+    static constexpr kernel_variant<cipher_kernels> variants[] = {
+    #if MUUID_DISPATCH_X86
+        {cpu_tier::avx512, &cipher_kernels_avx512},
+        {cpu_tier::avx2, &cipher_kernels_avx2},
+    #endif
+        {baseline_cpu_tier, &cipher_kernels_baseline}
+    };
+    static const kernel_variant<cipher_kernels> & ret = select_kernel(variants);
+    return ret;
+}
+
+void id_cipher::encrypt_blocks(const block * src, block * dest, size_t count) const noexcept {
+    get_cipher_kernels().table->encrypt(this->m_round_keys, src, dest, count);
+}
+
+void id_cipher::decrypt_blocks(const block * src, block * dest, size_t count) const noexcept {
+    get_cipher_kernels().table->decrypt(this->m_round_keys, src, dest, count);
+}
+
+void id_cipher::encrypt_blocks_preserving_version(const block * src, block * dest, size_t count) const noexcept {
+    get_cipher_kernels().table->encrypt_preserving_version(this->m_round_keys, src, dest, count);
+}
+
+void id_cipher::decrypt_blocks_preserving_version(const block * src, block * dest, size_t count) const noexcept {
+    get_cipher_kernels().table->decrypt_preserving_version(this->m_round_keys, src, dest, count);
+}
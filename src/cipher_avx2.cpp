@@ -0,0 +1,15 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//id_cipher kernels compiled for AVX2
+#include "cipher_kernels.h"
+
+#if MUUID_DISPATCH_X86
+
+MUUID_TARGET_BEGIN(MUUID_TARGET_AVX2)
+#include "cipher_kernels_impl.h"
+MUUID_TARGET_END
+
+const muuid::impl::cipher_kernels muuid::impl::cipher_kernels_avx2 = make_cipher_kernels();
+
+#endif
@@ -0,0 +1,33 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_CIPHER_KERNELS_H_INCLUDED
+#define HEADER_MODERN_UUID_CIPHER_KERNELS_H_INCLUDED
+
+#include "cpu_dispatch.h"
+
+#include <array>
+#include <bit>
+
+namespace muuid::impl {
+
+    struct cipher_kernels {
+        using block = std::array<uint8_t, 16>;
+        using func = void (*)(const uint64_t * round_keys, const block * src, block * dest, size_t count) noexcept;
+
+        func encrypt;
+        func decrypt;
+        func encrypt_preserving_version;
+        func decrypt_preserving_version;
+    };
+
+    extern const cipher_kernels cipher_kernels_baseline;
+#if MUUID_DISPATCH_X86
+    extern const cipher_kernels cipher_kernels_avx2;
+    extern const cipher_kernels cipher_kernels_avx512;
+#endif
+
+    auto get_cipher_kernels() noexcept -> const kernel_variant<cipher_kernels> &;
+}
+
+#endif
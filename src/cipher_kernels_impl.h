@@ -0,0 +1,186 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Implementation of id_cipher kernels. This file is included by one translation unit per 
+//instruction set tier, each compiled for its tier. Everything here has internal linkage
+//so the copies compiled for different tiers cannot be mixed up by the linker.
+
+#include "cipher_kernels.h"
+#include "kernel_helpers.h"
+
+//All the kernels below process N independent blocks at a time, one round for all
+//of them before moving to the next. With N > 1 the inner loops are simple
+//element-wise operations that compilers turn into SIMD code.
+
+namespace {
+
+    constexpr size_t lanes = 8;
+    constexpr size_t speck_rounds = 32;
+    constexpr size_t feistel_rounds = 8;
+    constexpr uint64_t mask61 = (uint64_t(1) << 61) - 1;
+    //domain separation for the Feistel round function, "preserve" in ASCII
+    constexpr uint64_t feistel_tweak = 0x7072657365727665;
+
+    template<size_t N>
+    inline void speck_encrypt(uint64_t (&x)[N], uint64_t (&y)[N], const uint64_t * round_keys) {
+        for (size_t r = 0; r < speck_rounds; ++r) {
+            const uint64_t k = round_keys[r];
+            for (size_t i = 0; i < N; ++i) {
+                x[i] = (std::rotr(x[i], 8) + y[i]) ^ k;
+                y[i] = std::rotl(y[i], 3) ^ x[i];
+            }
+        }
+    }
+
+    template<size_t N>
+    inline void speck_decrypt(uint64_t (&x)[N], uint64_t (&y)[N], const uint64_t * round_keys) {
+        for (size_t r = speck_rounds; r-- > 0; ) {
+            const uint64_t k = round_keys[r];
+            for (size_t i = 0; i < N; ++i) {
+                y[i] = std::rotr(y[i] ^ x[i], 3);
+                x[i] = std::rotl((x[i] ^ k) - y[i], 8);
+            }
+        }
+    }
+
+    //The 122 bits of UUID other than version and top 2 bits of variant are split into
+    //two 61-bit halves and run through a Feistel network with Speck as the round function
+    struct split_uuid {
+        uint64_t left;
+        uint64_t right;
+        uint64_t fixed_high;
+        uint64_t fixed_low;
+
+        void load(const uint8_t * src) {
+            uint64_t high = load_be(src);
+            uint64_t low = load_be(src + 8);
+            this->fixed_high = high & 0xF000;
+            this->fixed_low = low & ~(uint64_t(-1) >> 2);
+            uint64_t h = ((high >> 16) << 12) | (high & 0x0FFF);
+            uint64_t l = low & (uint64_t(-1) >> 2);
+            this->left = (h << 1) | (l >> 61);
+            this->right = l & mask61;
+        }
+
+        void store(uint8_t * dest) const {
+            uint64_t h = this->left >> 1;
+            uint64_t l = ((this->left & 1) << 61) | this->right;
+            store_be(((h >> 12) << 16) | this->fixed_high | (h & 0x0FFF), dest);
+            store_be(this->fixed_low | l, dest + 8);
+        }
+    };
+
+    template<size_t N>
+    inline void feistel_round_function(const uint64_t (&in)[N], size_t round, uint64_t (&out)[N],
+                                       const uint64_t * round_keys) {
+        uint64_t tweak[N];
+        for (size_t i = 0; i < N; ++i) {
+            out[i] = in[i];
+            tweak[i] = feistel_tweak ^ round;
+        }
+        speck_encrypt(out, tweak, round_keys);
+        for (size_t i = 0; i < N; ++i)
+            out[i] &= mask61;
+    }
+
+    template<class Kernel>
+    inline void for_each_block(const std::array<uint8_t, 16> * src, std::array<uint8_t, 16> * dest, size_t count,
+                               Kernel kernel) {
+        size_t i = 0;
+        for ( ; count - i >= lanes; i += lanes)
+            kernel.template operator()<lanes>(src + i, dest + i);
+        for ( ; i < count; ++i)
+            kernel.template operator()<1>(src + i, dest + i);
+    }
+
+    using block = muuid::impl::cipher_kernels::block;
+
+    void encrypt_blocks(const uint64_t * round_keys, const block * src, block * dest, size_t count) noexcept {
+        for_each_block(src, dest, count, [round_keys]<size_t N>(const block * s, block * d) {
+            uint64_t x[N], y[N];
+            for (size_t i = 0; i < N; ++i) {
+                x[i] = load_be(s[i].data());
+                y[i] = load_be(s[i].data() + 8);
+            }
+            speck_encrypt(x, y, round_keys);
+            for (size_t i = 0; i < N; ++i) {
+                store_be(x[i], d[i].data());
+                store_be(y[i], d[i].data() + 8);
+            }
+        });
+    }
+
+    void decrypt_blocks(const uint64_t * round_keys, const block * src, block * dest, size_t count) noexcept {
+        for_each_block(src, dest, count, [round_keys]<size_t N>(const block * s, block * d) {
+            uint64_t x[N], y[N];
+            for (size_t i = 0; i < N; ++i) {
+                x[i] = load_be(s[i].data());
+                y[i] = load_be(s[i].data() + 8);
+            }
+            speck_decrypt(x, y, round_keys);
+            for (size_t i = 0; i < N; ++i) {
+                store_be(x[i], d[i].data());
+                store_be(y[i], d[i].data() + 8);
+            }
+        });
+    }
+
+    void encrypt_blocks_preserving_version(const uint64_t * round_keys, const block * src, block * dest, size_t count) noexcept {
+        for_each_block(src, dest, count, [round_keys]<size_t N>(const block * s, block * d) {
+            split_uuid parts[N];
+            uint64_t left[N], right[N], f[N];
+            for (size_t i = 0; i < N; ++i) {
+                parts[i].load(s[i].data());
+                left[i] = parts[i].left;
+                right[i] = parts[i].right;
+            }
+            for (size_t r = 0; r < feistel_rounds; ++r) {
+                feistel_round_function(right, r, f, round_keys);
+                for (size_t i = 0; i < N; ++i) {
+                    uint64_t new_right = left[i] ^ f[i];
+                    left[i] = right[i];
+                    right[i] = new_right;
+                }
+            }
+            for (size_t i = 0; i < N; ++i) {
+                parts[i].left = left[i];
+                parts[i].right = right[i];
+                parts[i].store(d[i].data());
+            }
+        });
+    }
+
+    void decrypt_blocks_preserving_version(const uint64_t * round_keys, const block * src, block * dest, size_t count) noexcept {
+        for_each_block(src, dest, count, [round_keys]<size_t N>(const block * s, block * d) {
+            split_uuid parts[N];
+            uint64_t left[N], right[N], f[N];
+            for (size_t i = 0; i < N; ++i) {
+                parts[i].load(s[i].data());
+                left[i] = parts[i].left;
+                right[i] = parts[i].right;
+            }
+            for (size_t r = feistel_rounds; r-- > 0; ) {
+                feistel_round_function(left, r, f, round_keys);
+                for (size_t i = 0; i < N; ++i) {
+                    uint64_t old_left = right[i] ^ f[i];
+                    right[i] = left[i];
+                    left[i] = old_left;
+                }
+            }
+            for (size_t i = 0; i < N; ++i) {
+                parts[i].left = left[i];
+                parts[i].right = right[i];
+                parts[i].store(d[i].data());
+            }
+        });
+    }
+
+    constexpr muuid::impl::cipher_kernels make_cipher_kernels() {
+        return {
+            encrypt_blocks,
+            decrypt_blocks,
+            encrypt_blocks_preserving_version,
+            decrypt_blocks_preserving_version
+        };
+    }
+}
@@ -8,6 +8,7 @@
 #include "random_generator.h"
 #include "fork_handler.h"
 #include "threading.h"
+#include "cpu_clock.h"
 
 #include <cstring>
 #include <cassert>
@@ -61,7 +62,7 @@ namespace {
             return desired;
         }
     private:
-        mutable spinlock_if_multithreaded m_lock;
+        mutable adaptive_lock_if_multithreaded m_lock;
         T * m_p = nullptr;
     };
 
@@ -133,15 +134,69 @@ static system_clock::duration get_clock_tick() {
     return max_adjustment;
 }
 
+static atomic_if_multithreaded<clock_source> g_clock_source{clock_source::system};
+
+static inline system_clock::time_point read_clock() {
+    if (g_clock_source.get() == clock_source::cpu_counter)
+        return cpu_clock_now();
+    return system_clock::now();
+}
+
 static inline system_clock::time_point next_distinct_now(system_clock::time_point prev) {
     for ( ; ; ) {
-        auto now = system_clock::now();
+        auto now = read_clock();
+        if (now != prev) {
+            return now;
+        }
+    }
+}
+
+//Lower bound for the clock used by the hybrid logical clock generators (v7 and ULID). 
+//It is raised by observe() past timestamps seen in IDs from other hosts so that anything 
+//we generate afterwards sorts after them. Stored as system_clock::rep to stay lock-free.
+static atomic_if_multithreaded<system_clock::rep> g_hybrid_clock_floor{0};
+
+static inline system_clock::time_point hybrid_now(bool & pinned) {
+    auto now = read_clock();
+    auto floor = system_clock::time_point(system_clock::duration(g_hybrid_clock_floor.get()));
+    pinned = (floor > now);
+    return pinned ? floor : now;
+}
+
+static inline void raise_hybrid_clock_floor(system_clock::rep desired) {
+    for (auto current = g_hybrid_clock_floor.get(); current < desired; ) {
+        if (g_hybrid_clock_floor.compare_exchange(current, desired))
+            break;
+    }
+}
+
+static inline system_clock::time_point next_distinct_hybrid_now(system_clock::time_point prev, 
+                                                                system_clock::duration step,
+                                                                bool & pinned) {
+    for ( ; ; ) {
+        auto now = hybrid_now(pinned);
         if (now != prev) {
             return now;
         }
+        //We are pinned to the floor which is ahead of the real clock and have exhausted it.
+        //Waiting for the real clock could take arbitrarily long so move the floor forward instead.
+        //If somebody else moved it already the CAS fails and we simply re-read.
+        auto expected = prev.time_since_epoch().count();
+        g_hybrid_clock_floor.compare_exchange(expected, (prev + step).time_since_epoch().count());
     }
 }
 
+static bool observe_hybrid_clock(milliseconds observed, milliseconds max_skew) {
+    auto now = duration_cast<milliseconds>(read_clock().time_since_epoch());
+    //check the skew in milliseconds before converting to avoid overflow on garbage input
+    if (observed > now && observed - now > max_skew)
+        return false;
+    if (observed >= duration_cast<milliseconds>(system_clock::duration::max()))
+        return false;
+    raise_hybrid_clock_floor(duration_cast<system_clock::duration>(observed + 1ms).count());
+    return true;
+}
+
 namespace {
 
     template<class Data>
@@ -200,6 +255,53 @@ namespace {
         typename generic_clock_persistence<Data>::per_thread * m_per_thread = nullptr;
     };
 
+    class clock_regression_control {
+    public:
+        void set_max_borrow(nanoseconds val) noexcept {
+            this->m_max_borrow.set(std::max(val, 0ns).count());
+        }
+
+        //Called when the clock reading is behind the last used time by borrow.
+        //first indicates start of a new regression rather than continuation of existing one
+        //Returns whether the generator should keep going from the last used time
+        bool on_regression(nanoseconds borrow, bool first) noexcept {
+            if (first)
+                this->m_regressions.fetch_add(1);
+            if (borrow.count() > this->m_max_borrow.get()) {
+                this->m_resets.fetch_add(1);
+                return false;
+            }
+            if (first)
+                this->m_last_borrow.set(borrow.count());
+            else
+                raise(this->m_last_borrow, borrow.count());
+            raise(this->m_max_seen_borrow, borrow.count());
+            return true;
+        }
+
+        auto statistics() noexcept -> uuid_clock_statistics {
+            return {
+                this->m_regressions.get(),
+                this->m_resets.get(),
+                nanoseconds(this->m_last_borrow.get()),
+                nanoseconds(this->m_max_seen_borrow.get())
+            };
+        }
+    private:
+        static void raise(atomic_if_multithreaded<nanoseconds::rep> & val, nanoseconds::rep desired) noexcept {
+            for (auto current = val.get(); current < desired; ) {
+                if (val.compare_exchange(current, desired))
+                    break;
+            }
+        }
+    private:
+        atomic_if_multithreaded<nanoseconds::rep> m_max_borrow{0};
+        atomic_if_multithreaded<uint64_t> m_regressions{0};
+        atomic_if_multithreaded<uint64_t> m_resets{0};
+        atomic_if_multithreaded<nanoseconds::rep> m_last_borrow{0};
+        atomic_if_multithreaded<nanoseconds::rep> m_max_seen_borrow{0};
+    };
+
     template<class Derived, class PersData, class UnitDuration, class MaxUnitDuration>
     class clock_state_base {
     public:
@@ -287,7 +389,7 @@ namespace {
     public:
         void get(time_point<system_clock, MaxUnitDuration> & adjusted_now, uint16_t & clock_seq) {
             this->mutate([&](uuid_persistence_data & data) {
-                for (auto now = system_clock::now(); ; now = next_distinct_now(now)) {
+                for (auto now = read_clock(); ; now = next_distinct_now(now)) {
                     if (this->adjust(now, adjusted_now, clock_seq))
                         break;
                 }
@@ -350,8 +452,8 @@ namespace {
         uint16_t m_clock_seq = 0;
     };
 
-    template<class UnitDuration, class MaxUnitDuration>
-    class monotonic_clock_state : public clock_state_base<monotonic_clock_state<UnitDuration, MaxUnitDuration>,
+    template<class UnitDuration, class MaxUnitDuration, bool Hybrid = false>
+    class monotonic_clock_state : public clock_state_base<monotonic_clock_state<UnitDuration, MaxUnitDuration, Hybrid>,
                                                           uuid_persistence_data,
                                                           UnitDuration, MaxUnitDuration> {
         friend clock_state_base<monotonic_clock_state, uuid_persistence_data, UnitDuration, MaxUnitDuration>;
@@ -367,14 +469,41 @@ namespace {
             return ret;
         }
         
-        void get(time_point<system_clock, MaxUnitDuration> & adjusted_now, uint16_t & clock_seq) {
+        void get(time_point<system_clock, MaxUnitDuration> & adjusted_now, uint16_t & clock_seq,
+                 clock_regression_control & regression_control) {
+
+            this->get_many(1, regression_control, [&](time_point<system_clock, MaxUnitDuration> when, uint16_t seq) {
+                adjusted_now = when;
+                clock_seq = seq;
+            });
+        }
+
+        //Reserves count consecutive clock values at once, calling func(adjusted_now, clock_seq) for each.
+        //The clock is read once for the whole batch and again only if the values for the current reading
+        //run out.
+        template<class Func>
+        void get_many(size_t count, clock_regression_control & regression_control, Func && func) {
 
             this->mutate([&](uuid_persistence_data & data) {
-                auto now = system_clock::now();
-                if (!this->adjust(now, adjusted_now, clock_seq, false)) {
-                    do {
-                        now = next_distinct_now(now);
-                    } while (!this->adjust(now, adjusted_now, clock_seq, true));
+                bool pinned;
+                auto now = monotonic_clock_state::read_now(pinned);
+                time_point<system_clock, MaxUnitDuration> adjusted_now;
+                uint16_t clock_seq;
+                for (size_t i = 0; i < count; ++i) {
+                    if (!this->adjust(now, adjusted_now, clock_seq, false, regression_control)) {
+                        do {
+                            now = monotonic_clock_state::read_next_distinct_now(now, pinned);
+                        } while (!this->adjust(now, adjusted_now, clock_seq, true, regression_control));
+                    }
+                    func(adjusted_now, clock_seq);
+                }
+                if constexpr (Hybrid) {
+                    //While pinned to the floor publish what we used so that other threads
+                    //(and forked children) with their own state continue after it.
+                    if (pinned && !this->m_borrowing) {
+                        auto next = time_point_cast<system_clock::duration>(adjusted_now + MaxUnitDuration(1));
+                        raise_hybrid_clock_floor(next.time_since_epoch().count());
+                    }
                 }
                 assert(this->m_adjustment <= std::numeric_limits<int32_t>::max());
                 data = { time_point_cast<nanoseconds>(this->m_last_time), this->m_clock_seq, int32_t(this->m_adjustment)};
@@ -385,6 +514,26 @@ namespace {
         monotonic_clock_state() = default;
         ~monotonic_clock_state() = default; 
 
+        static system_clock::time_point read_now(bool & pinned) {
+            if constexpr (Hybrid) {
+                return hybrid_now(pinned);
+            } else {
+                pinned = false;
+                return read_clock();
+            }
+        }
+
+        static system_clock::time_point read_next_distinct_now(system_clock::time_point prev, bool & pinned) {
+            if constexpr (Hybrid) {
+                static const auto step = std::max(get_clock_tick(), 
+                                                  duration_cast<system_clock::duration>(MaxUnitDuration(1)));
+                return next_distinct_hybrid_now(prev, step, pinned);
+            } else {
+                pinned = false;
+                return next_distinct_now(prev);
+            }
+        }
+
         void init_new(uuid_persistence_data & data) {
             this->m_last_time = round<MaxUnitDuration>(system_clock::now()) - 1s;
             auto & gen = get_random_generator();
@@ -404,7 +553,7 @@ namespace {
         }
 
         bool adjust(system_clock::time_point now, time_point<system_clock, MaxUnitDuration> & adjusted, uint16_t & clock_seq,
-                    bool after_wait) {
+                    bool after_wait, clock_regression_control & regression_control) {
 
             adjusted = round<MaxUnitDuration>(now);
             //on a miniscule change that we have misdetected m_max_adjustment let's make sure
@@ -416,14 +565,35 @@ namespace {
             }
             
             if (adjusted < this->m_last_time) {
-                //we lost monotonicity
-                //reset everything to current time and base state
-                auto & gen = get_random_generator();
-                std::uniform_int_distribution<uint16_t> clock_seq_distrib(0, 0x3FFF / 2);
-                this->m_clock_seq = clock_seq_distrib(gen);
-                this->m_adjustment = 0;
-                this->m_last_time = adjusted;
+                auto borrow = duration_cast<nanoseconds>(this->m_last_time - adjusted);
+                bool first = !this->m_borrowing;
+                this->m_borrowing = regression_control.on_regression(borrow, first);
+                if (this->m_borrowing) {
+                    //keep going from the last used time until the clock catches up
+                    adjusted = this->m_last_time;
+                    if (this->m_adjustment >= this->m_max_adjustment) {
+                        uint16_t new_clock_seq = (this->m_clock_seq + 1) & 0x3FFF;
+                        if (new_clock_seq == 0) {
+                            //waiting for the clock is pointless - it is behind. Borrow one more tick instead
+                            this->m_last_time += MaxUnitDuration(this->m_max_adjustment + 1);
+                            this->m_adjustment = 0;
+                            adjusted = this->m_last_time;
+                        }
+                        this->m_clock_seq = new_clock_seq;
+                    } else {
+                        ++this->m_adjustment;
+                    }
+                } else {
+                    //we lost monotonicity
+                    //reset everything to current time and base state
+                    auto & gen = get_random_generator();
+                    std::uniform_int_distribution<uint16_t> clock_seq_distrib(0, 0x3FFF / 2);
+                    this->m_clock_seq = clock_seq_distrib(gen);
+                    this->m_adjustment = 0;
+                    this->m_last_time = adjusted;
+                }
             } else if (adjusted == this->m_last_time) {
+                this->m_borrowing = false;
                 if (this->m_adjustment >= this->m_max_adjustment) {
                     uint16_t new_clock_seq = (this->m_clock_seq + 1) & 0x3FFF;
                     if (new_clock_seq == 0)
@@ -433,6 +603,7 @@ namespace {
                     ++this->m_adjustment;
                 }
             } else {
+                this->m_borrowing = false;
                 this->m_adjustment = 0;
                 this->m_last_time = adjusted;
                 if (after_wait) {
@@ -448,6 +619,119 @@ namespace {
         }
     private:
         uint16_t m_clock_seq = 0;
+        bool m_borrowing = false;
+    };
+
+    //Implements UUID v7 layout with a fixed-length counter randomly seeded each millisecond
+    //(RFC 9562, section 6.2, method 1)
+    class counter_clock_state : public clock_state_base<counter_clock_state,
+                                                        uuid_persistence_data,
+                                                        milliseconds, milliseconds> {
+        friend clock_state_base<counter_clock_state, uuid_persistence_data, milliseconds, milliseconds>;
+        friend muuid::impl::singleton_holder<counter_clock_state>;
+        friend muuid::impl::reset_on_fork_thread_local<counter_clock_state>;
+
+    public:
+        static constexpr unsigned counter_bits = 42;
+        static constexpr uint64_t max_counter = (uint64_t(1) << counter_bits) - 1;
+
+        //Reserves count consecutive counter values at once, calling func(adjusted_now, counter) for each
+        template<class Func>
+        void get_many(size_t count, clock_regression_control & regression_control, Func && func) {
+            this->mutate([&](uuid_persistence_data & data) {
+                if (this->m_has_floor) {
+                    this->m_has_floor = false;
+                    if (this->m_floor_time > this->m_last_time || 
+                        (this->m_floor_time == this->m_last_time && this->m_floor_counter > this->m_counter)) {
+                        this->m_last_time = this->m_floor_time;
+                        this->m_counter = this->m_floor_counter;
+                    }
+                }
+                bool pinned;
+                const auto now = floor<milliseconds>(hybrid_now(pinned));
+                for (size_t i = 0; i < count; ++i) {
+                    this->adjust(now, regression_control);
+                    func(this->m_last_time, this->m_counter);
+                }
+                this->save(data);
+            });
+        }
+
+        //Makes the next value follow a UUID with the given millisecond and counter value 
+        //produced by the other layout
+        void continue_after(time_point<system_clock, milliseconds> when, uint64_t counter) {
+            this->m_floor_time = when;
+            this->m_floor_counter = std::min(counter, max_counter);
+            this->m_has_floor = true;
+        }
+    private:
+        counter_clock_state() = default;
+        ~counter_clock_state() = default;
+
+        void init_new(uuid_persistence_data & data) {
+            this->m_last_time = floor<milliseconds>(system_clock::now()) - 1s;
+            this->reseed();
+            this->save(data);
+        }
+
+        //The counter is stored in seq and adjustment fields with adjustment always negative. 
+        //This way if the data is accidentally read by the other v7 layout it is treated as no adjustment.
+        void load_existing(const uuid_persistence_data & data) {
+            this->m_last_time = time_point_cast<milliseconds>(data.when);
+            if (data.adjustment < 0) {
+                uint64_t low = uint32_t(-1 - int64_t(data.adjustment));
+                this->m_counter = (uint64_t(data.seq & 0x7FF) << 31) | low;
+            } else {
+                //data from the other layout: we know nothing about the counter so don't reuse this millisecond
+                this->m_counter = max_counter;
+            }
+        }
+
+        void save(uuid_persistence_data & data) const {
+            data.when = time_point_cast<nanoseconds>(this->m_last_time);
+            data.seq = uint16_t(this->m_counter >> 31);
+            data.adjustment = int32_t(-1 - int64_t(this->m_counter & 0x7FFFFFFF));
+        }
+
+        void adjust(time_point<system_clock, milliseconds> now, clock_regression_control & regression_control) {
+            if (now < this->m_last_time) {
+                auto borrow = duration_cast<nanoseconds>(this->m_last_time - now);
+                bool first = !this->m_borrowing;
+                this->m_borrowing = regression_control.on_regression(borrow, first);
+                if (!this->m_borrowing) {
+                    //we lost monotonicity
+                    this->m_last_time = now;
+                    this->reseed();
+                    return;
+                }
+            } else {
+                this->m_borrowing = false;
+                if (now > this->m_last_time) {
+                    this->m_last_time = now;
+                    this->reseed();
+                    return;
+                }
+            }
+            if (this->m_counter >= max_counter) {
+                //counter exhausted: rather than waiting move to the next millisecond
+                this->m_last_time += 1ms;
+                this->reseed();
+            } else {
+                ++this->m_counter;
+            }
+        }
+
+        void reseed() {
+            //leave the top bit clear to make room for at least 2^41 increments
+            auto & gen = get_random_generator();
+            this->m_counter = ((uint64_t(gen()) << 32) | gen()) & (max_counter >> 1);
+        }
+    private:
+        uint64_t m_counter = 0;
+        bool m_borrowing = false;
+        time_point<system_clock, milliseconds> m_floor_time;
+        uint64_t m_floor_counter = 0;
+        bool m_has_floor = false;
     };
 
     class ulid_clock_state : public clock_state_base<ulid_clock_state,
@@ -464,12 +748,17 @@ namespace {
             return ret;
         }
 
-        void get(time_point<system_clock, milliseconds> & adjusted_now, uint64_t & tail_low, uint16_t & tail_high) {
+        //Reserves count consecutive clock values at once, calling func(adjusted_now, tail_low, tail_high) for each
+        template<class Func>
+        void get_many(size_t count, Func && func) {
             mutate([&](ulid_persistence_data & data) {
-                auto now = system_clock::now();
-                adjust(now, adjusted_now);
-                tail_low = m_tail.low;
-                tail_high = m_tail.high;
+                bool pinned;
+                const auto now = hybrid_now(pinned);
+                time_point<system_clock, milliseconds> adjusted_now;
+                for (size_t i = 0; i < count; ++i) {
+                    adjust(now, adjusted_now);
+                    func(adjusted_now, m_tail.low, m_tail.high);
+                }
                 data.when = m_last_time;
                 assert(m_adjustment <= std::numeric_limits<int32_t>::max());
                 data.adjustment = int32_t(this->m_adjustment);
@@ -481,7 +770,7 @@ namespace {
         ~ulid_clock_state() = default; 
 
         void init_new(ulid_persistence_data & data) {
-            m_last_time = round<milliseconds>(system_clock::now()) - 1s;
+            m_last_time = floor<milliseconds>(system_clock::now()) - 1s;
             m_tail.fill_random();
             m_adjustment = 0;
             data.when = m_last_time;
@@ -500,7 +789,7 @@ namespace {
 
         void adjust(system_clock::time_point now, time_point<system_clock, milliseconds> & adjusted) {
 
-            adjusted = round<milliseconds>(now);
+            adjusted = floor<milliseconds>(now);
             //on a miniscule change that we have misdetected m_max_adjustment let's make sure
             //that adjusted is rounded on the m_max_adjustment boundary to avoid spillover
             if (m_max_adjustment != 0) {
@@ -546,6 +835,9 @@ namespace {
 
 }
 
+static clock_regression_control g_clock_regression_v6;
+static clock_regression_control g_clock_regression_v7;
+static atomic_if_multithreaded<unix_time_based_layout> g_unix_time_based_layout{unix_time_based_layout::sub_millisecond};
 
 clock_result_v1 muuid::impl::get_clock_v1() {
     using state_type = non_repeatable_clock_state<hundred_nanoseconds, hundred_nanoseconds>;
@@ -576,7 +868,7 @@ clock_result_v6 muuid::impl::get_clock_v6() {
     
     time_point<system_clock, hundred_nanoseconds> adjusted_now;
     uint16_t clock_seq;
-    per_thread_state.get(adjusted_now, clock_seq);
+    per_thread_state.get(adjusted_now, clock_seq, g_clock_regression_v6);
 
     uint64_t clock = adjusted_now.time_since_epoch().count();
     //gregorian offset of Unix epoch
@@ -586,41 +878,98 @@ clock_result_v6 muuid::impl::get_clock_v6() {
 }
 
 clock_result_v7 muuid::impl::get_clock_v7() {
-    using state_type = monotonic_clock_state<milliseconds, microseconds>;
+    clock_result_v7 ret;
+    get_clock_v7(&ret, 1);
+    return ret;
+}
+
+void muuid::impl::get_clock_v7(clock_result_v7 * dest, size_t count) {
+    using state_type = monotonic_clock_state<milliseconds, microseconds, true>;
+
+    //The last UUID generated on this thread. Both layouts put the millisecond first, followed by 
+    //12 bits of rand_a and 14 bits of rand_b, so when the layout changes the new one continues 
+    //after those rather than from its own, unrelated, state.
+    struct last_generated {
+        uint64_t value = 0;
+        uint32_t prefix = 0;
+        std::optional<unix_time_based_layout> layout;
+    };
+    static thread_local last_generated t_last;
+
+    if (count == 0)
+        return;
 
     auto * current_pers = g_clock_persistence_v7.load();
     ref_release rel{current_pers};
-    auto & per_thread_state = reset_on_fork_thread_local<state_type, 7>::instance();
-    per_thread_state.set_persistence(current_pers);
-    
-    time_point<system_clock, microseconds> adjusted_now;
-    uint16_t clock_seq;
-    per_thread_state.get(adjusted_now, clock_seq);
 
-    auto interval = adjusted_now.time_since_epoch();
-    auto interval_ms = duration_cast<milliseconds>(interval);
+    const auto layout = g_unix_time_based_layout.get();
+    const bool switched = t_last.layout && *t_last.layout != layout;
+    auto * const first = dest;
+
+    if (layout == unix_time_based_layout::counter) {
+        auto & per_thread_state = reset_on_fork_thread_local<counter_clock_state>::instance();
+        per_thread_state.set_persistence(current_pers);
+        if (switched) {
+            //fill the 16 counter bits below the prefix so that the next increment moves past it
+            per_thread_state.continue_after(time_point<system_clock, milliseconds>(milliseconds(t_last.value)),
+                                            (uint64_t(t_last.prefix) << 16) | 0xFFFF);
+        }
 
-    uint64_t clock = interval_ms.count();
-    uint64_t remainder = (interval - duration_cast<microseconds>(interval_ms)).count();
-    uint64_t frac = remainder * 4096;
-    uint16_t extra = uint16_t(frac / 1000) + uint16_t(frac % 1000 >= 500);
-    return {clock, extra, clock_seq};
+        per_thread_state.get_many(count, g_clock_regression_v7, [&](time_point<system_clock, milliseconds> adjusted_now, uint64_t counter) {
+            uint64_t clock = adjusted_now.time_since_epoch().count();
+            *dest++ = {clock, uint16_t(counter >> 30), uint16_t((counter >> 16) & 0x3FFF), uint16_t(counter), true};
+        });
+    } else {
+        if (switched) {
+            //Start at the first microsecond whose fraction, as rounded below, is past the last prefix. 
+            //This is done via the hybrid clock floor so that the state sees it as the current time.
+            uint64_t extra = t_last.prefix >> 14;
+            auto micros = microseconds(((2 * extra + 1) * 1000 + 8191) / 8192);
+            auto after = milliseconds(t_last.value) + std::min(micros, microseconds(1ms));
+            raise_hybrid_clock_floor(duration_cast<system_clock::duration>(after).count());
+        }
+        auto & per_thread_state = reset_on_fork_thread_local<state_type, 7>::instance();
+        per_thread_state.set_persistence(current_pers);
+        
+        per_thread_state.get_many(count, g_clock_regression_v7, [&](time_point<system_clock, microseconds> adjusted_now, uint16_t clock_seq) {
+            auto interval = adjusted_now.time_since_epoch();
+            auto interval_ms = duration_cast<milliseconds>(interval);
+
+            uint64_t clock = interval_ms.count();
+            uint64_t remainder = (interval - duration_cast<microseconds>(interval_ms)).count();
+            uint64_t frac = remainder * 4096;
+            uint16_t extra = uint16_t(frac / 1000) + uint16_t(frac % 1000 >= 500);
+            *dest++ = {clock, extra, clock_seq, 0, false};
+        });
+    }
+
+    const auto & last = first[count - 1];
+    t_last = {last.value, (uint32_t(last.extra) << 14) | last.sequence, layout};
 }
 
 clock_result_ulid muuid::impl::get_clock_ulid() {
+    clock_result_ulid ret;
+    get_clock_ulid(&ret, 1);
+    return ret;
+}
+
+void muuid::impl::get_clock_ulid(clock_result_ulid * dest, size_t count) {
 
     auto * current_pers = g_clock_persistence_ulid.load();
     ref_release rel{current_pers};
     auto & per_thread_state = reset_on_fork_thread_local<ulid_clock_state>::instance();
     per_thread_state.set_persistence(current_pers);
 
-    time_point<system_clock, milliseconds> adjusted_now;
-    uint64_t tail_low;
-    uint16_t tail_high;
-    per_thread_state.get(adjusted_now, tail_low, tail_high);
+    per_thread_state.get_many(count, [&](time_point<system_clock, milliseconds> adjusted_now, uint64_t tail_low, uint16_t tail_high) {
+        auto interval = adjusted_now.time_since_epoch();
+        *dest++ = {uint64_t(interval.count()), tail_low, tail_high};
+    });
+}
 
-    auto interval = adjusted_now.time_since_epoch();
-    return {uint64_t(interval.count()), tail_low, tail_high};
+uint64_t muuid::impl::get_clock_ulid_unordered() {
+    bool pinned;
+    auto now = floor<milliseconds>(hybrid_now(pinned));
+    return uint64_t(now.time_since_epoch().count());
 }
 
 void muuid::set_time_based_persistence(uuid_clock_persistence * pers) {
@@ -647,6 +996,33 @@ void muuid::set_unix_time_based_persistence(uuid_clock_persistence * pers) {
         old->sub_ref();
 }
 
+void muuid::set_reordered_time_based_max_clock_borrow(std::chrono::nanoseconds max_borrow) noexcept {
+    g_clock_regression_v6.set_max_borrow(max_borrow);
+}
+
+void muuid::set_unix_time_based_max_clock_borrow(std::chrono::nanoseconds max_borrow) noexcept {
+    g_clock_regression_v7.set_max_borrow(max_borrow);
+}
+
+bool muuid::set_clock_source(clock_source source) noexcept {
+    if (source == clock_source::cpu_counter && !cpu_clock_available())
+        return false;
+    g_clock_source.set(source);
+    return true;
+}
+
+void muuid::set_unix_time_based_layout(unix_time_based_layout layout) noexcept {
+    g_unix_time_based_layout.set(layout);
+}
+
+auto muuid::get_reordered_time_based_clock_statistics() noexcept -> uuid_clock_statistics {
+    return g_clock_regression_v6.statistics();
+}
+
+auto muuid::get_unix_time_based_clock_statistics() noexcept -> uuid_clock_statistics {
+    return g_clock_regression_v7.statistics();
+}
+
 void muuid::set_ulid_persistence(ulid_clock_persistence * pers) {
 
     if (pers)
@@ -655,3 +1031,19 @@ void muuid::set_ulid_persistence(ulid_clock_persistence * pers) {
     if (old)
         old->sub_ref();
 }
+
+bool muuid::observe(const uuid & id, std::chrono::milliseconds max_skew) noexcept {
+    if (id.get_variant() != uuid::variant::standard || id.get_type() != uuid::type::unix_time_based)
+        return false;
+    uint64_t observed = 0;
+    for (size_t i = 0; i < 6; ++i)
+        observed = (observed << 8) | id.bytes[i];
+    return observe_hybrid_clock(milliseconds(int64_t(observed)), max_skew);
+}
+
+bool muuid::observe(const ulid & id, std::chrono::milliseconds max_skew) noexcept {
+    uint64_t observed = 0;
+    for (size_t i = 0; i < 6; ++i)
+        observed = (observed << 8) | id.bytes[i];
+    return observe_hybrid_clock(milliseconds(int64_t(observed)), max_skew);
+}
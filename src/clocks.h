@@ -5,6 +5,7 @@
 #define HEADER_MODERN_UUID_CLOCKS_H_INCLUDED
 
 #include <cstdint>
+#include <cstddef>
 
 
 namespace muuid::impl {
@@ -19,6 +20,8 @@ namespace muuid::impl {
         uint64_t value;
         uint16_t extra;
         uint16_t sequence;
+        uint16_t sequence_ext;
+        bool has_sequence_ext;
     };
 
     struct clock_result_ulid {
@@ -31,6 +34,10 @@ namespace muuid::impl {
     clock_result_v6 get_clock_v6();
     clock_result_v7 get_clock_v7();
     clock_result_ulid get_clock_ulid();
+    //Reserve count consecutive values under a single acquisition of the clock state
+    void get_clock_v7(clock_result_v7 * dest, size_t count);
+    void get_clock_ulid(clock_result_ulid * dest, size_t count);
+    uint64_t get_clock_ulid_unordered();
 }
 
 #endif
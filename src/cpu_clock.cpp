@@ -0,0 +1,179 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu_clock.h"
+
+#include <cstdint>
+#include <algorithm>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #if defined(_M_X64) || defined(_M_IX86)
+        #include <intrin.h>
+        #define MUUID_CPU_CLOCK_X86 1
+    #endif
+#elif defined(__clang__) || defined(__GNUC__)
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h>
+        #include <cpuid.h>
+        #define MUUID_CPU_CLOCK_X86 1
+    #elif defined(__aarch64__)
+        #define MUUID_CPU_CLOCK_ARM64 1
+    #endif
+#endif
+
+using namespace std::chrono;
+
+namespace {
+
+    struct calibration {
+        bool valid = false;
+        //system_clock ticks per counter tick
+        double scale = 0;
+        //counter ticks between re-anchoring to system_clock
+        uint64_t anchor_interval = 0;
+    };
+
+#if MUUID_CPU_CLOCK_X86
+
+    inline uint64_t read_counter() noexcept {
+        return __rdtsc();
+    }
+
+    bool has_invariant_counter() noexcept {
+        //CPUID.80000007H:EDX[8] indicates TSC that runs at constant rate in all ACPI states
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 0x80000000);
+        if (unsigned(regs[0]) < 0x80000007)
+            return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+    #else
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (edx & (1 << 8)) != 0;
+    #endif
+    }
+
+    uint64_t known_frequency() noexcept {
+        return 0;
+    }
+
+#elif MUUID_CPU_CLOCK_ARM64
+
+    inline uint64_t read_counter() noexcept {
+        uint64_t ret;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(ret) :: "memory");
+        return ret;
+    }
+
+    bool has_invariant_counter() noexcept {
+        //the generic timer is architecturally required to run at a fixed frequency
+        return true;
+    }
+
+    uint64_t known_frequency() noexcept {
+        uint64_t ret;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(ret));
+        return ret;
+    }
+
+#else
+
+    inline uint64_t read_counter() noexcept {
+        return 0;
+    }
+
+    bool has_invariant_counter() noexcept {
+        return false;
+    }
+
+    uint64_t known_frequency() noexcept {
+        return 0;
+    }
+
+#endif
+
+    calibration calibrate() noexcept {
+        calibration ret;
+        if (!has_invariant_counter())
+            return ret;
+
+        double ticks_per_second;
+        if (auto freq = known_frequency()) {
+            ticks_per_second = double(freq);
+        } else {
+            //measure against steady_clock which is not affected by system time adjustments
+            auto start = steady_clock::now();
+            auto start_ticks = read_counter();
+            steady_clock::time_point end;
+            do {
+                end = steady_clock::now();
+            } while (end - start < 5ms);
+            auto end_ticks = read_counter();
+            if (end_ticks <= start_ticks)
+                return ret;
+            ticks_per_second = double(end_ticks - start_ticks) / duration<double>(end - start).count();
+        }
+        //anything outside of this range indicates broken or emulated counter
+        if (ticks_per_second < 1e7 || ticks_per_second > 1e11)
+            return ret;
+
+        ret.scale = double(system_clock::period::den) / (ticks_per_second * double(system_clock::period::num));
+        ret.anchor_interval = uint64_t(ticks_per_second);
+        ret.valid = true;
+        return ret;
+    }
+
+    const calibration & get_calibration() noexcept {
+        static const calibration cal = calibrate();
+        return cal;
+    }
+
+    struct anchor {
+        uint64_t ticks = 0;
+        system_clock::time_point time;
+        system_clock::time_point last;
+        double scale = 0;
+    };
+}
+
+bool muuid::impl::cpu_clock_available() noexcept {
+    return get_calibration().valid;
+}
+
+system_clock::time_point muuid::impl::cpu_clock_now() noexcept {
+    static thread_local anchor t_anchor;
+
+    auto & cal = get_calibration();
+    auto & anc = t_anchor;
+
+    auto ticks = read_counter();
+    system_clock::time_point ret;
+    if (anc.scale == 0 || ticks < anc.ticks || ticks - anc.ticks >= cal.anchor_interval) {
+        //re-anchor to system_clock periodically so that we follow its adjustments
+        ret = system_clock::now();
+        ticks = read_counter();
+        if (anc.scale == 0) {
+            anc.scale = cal.scale;
+        } else if (ticks > anc.ticks) {
+            //adopt the observed rate if it is close to the calibrated one (NTP slew)
+            //but ignore it otherwise (system time was stepped)
+            double observed = double((ret - anc.time).count()) / double(ticks - anc.ticks);
+            if (observed > cal.scale * 0.999 && observed < cal.scale * 1.001)
+                anc.scale = observed;
+        }
+        anc.ticks = ticks;
+        anc.time = ret;
+    } else {
+        auto elapsed = system_clock::duration(system_clock::rep(double(ticks - anc.ticks) * anc.scale));
+        ret = anc.time + elapsed;
+    }
+    //hide small backward jumps caused by re-anchoring. Large ones are real system time
+    //changes and are passed through to be handled the same way as with system_clock
+    if (ret < anc.last && anc.last - ret < 1ms)
+        ret = anc.last;
+    anc.last = ret;
+    return ret;
+}
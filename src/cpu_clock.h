@@ -0,0 +1,28 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_CPU_CLOCK_H_INCLUDED
+#define HEADER_MODERN_UUID_CPU_CLOCK_H_INCLUDED
+
+#include <chrono>
+
+
+namespace muuid::impl {
+
+    /**
+     * Whether CPU counter is usable as a clock source on this machine
+     *
+     * The first call performs detection and calibration which takes a few milliseconds.
+     */
+    bool cpu_clock_available() noexcept;
+
+    /**
+     * Returns current time derived from CPU counter
+     *
+     * Must only be called if cpu_clock_available() returned true.
+     * Results are monotonic per thread and track system_clock.
+     */
+    std::chrono::system_clock::time_point cpu_clock_now() noexcept;
+}
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu_dispatch.h"
+#include "cipher_kernels.h"
+#include "partition_kernels.h"
+#include "set_operations_kernels.h"
+#include "sharding_kernels.h"
+
+#include <cstdlib>
+
+using namespace muuid;
+using namespace muuid::impl;
+
+static constexpr std::string_view g_tier_names[] = {
+    "generic",
+    "sse2",
+    "avx2",
+    "avx512",
+    "neon"
+};
+
+static cpu_tier detect_cpu_tier() noexcept {
+#if MUUID_DISPATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"))
+        return cpu_tier::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return cpu_tier::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return cpu_tier::sse2;
+    return cpu_tier::generic;
+#else
+    return baseline_cpu_tier;
+#endif
+}
+
+static std::optional<cpu_tier> get_tier_override() noexcept {
+    std::optional<cpu_tier> ret;
+#if defined(_MSC_VER)
+    char * value = nullptr;
+    size_t len = 0;
+    if (_dupenv_s(&value, &len, "MUUID_CPU_TIER") != 0 || !value)
+        return ret;
+    std::string_view name(value);
+#else
+    const char * value = getenv("MUUID_CPU_TIER");
+    if (!value)
+        return ret;
+    std::string_view name(value);
+#endif
+    for (size_t i = 0; i < std::size(g_tier_names); ++i) {
+        if (g_tier_names[i] == name) {
+            ret = cpu_tier(i);
+            break;
+        }
+    }
+#if defined(_MSC_VER)
+    free(value);
+#endif
+    return ret;
+}
+
+cpu_tier muuid::impl::max_cpu_tier() noexcept {
+    static const cpu_tier ret = []() {
+        auto detected = detect_cpu_tier();
+        if (auto requested = get_tier_override(); requested && *requested < detected)
+            return *requested;
+        return detected;
+    }();
+    return ret;
+}
+
+auto muuid::impl::cpu_tier_name(cpu_tier tier) noexcept -> std::string_view {
+    return g_tier_names[size_t(tier)];
+}
+
+auto muuid::active_kernels() noexcept -> std::span<const kernel_info> {
+    static const kernel_info ret[] = {
+        {"id_cipher", cpu_tier_name(get_cipher_kernels().tier)},
+        {"shard_of", cpu_tier_name(get_sharding_kernels().tier)},
+        {"partition_by_time", cpu_tier_name(get_partition_kernels().tier)},
+        {"set_operations", cpu_tier_name(get_set_operations_kernels().tier)}
+    };
+    return ret;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_CPU_DISPATCH_H_INCLUDED
+#define HEADER_MODERN_UUID_CPU_DISPATCH_H_INCLUDED
+
+#include <modern-uuid/common.h>
+
+#include <bit>
+
+//Whether kernels for higher x86 tiers can be compiled via target pragmas in 
+//their own translation units
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+    #define MUUID_DISPATCH_X86 1
+
+    #define MUUID_PRAGMA(...) _Pragma(#__VA_ARGS__)
+
+    //Functions defined between these compile for the given target, e.g. "avx2". Standard headers 
+    //must be included before MUUID_TARGET_BEGIN so that only our kernels are affected by it.
+    #if defined(__clang__)
+        #define MUUID_TARGET_BEGIN(isa) MUUID_PRAGMA(clang attribute push (__attribute__((target(isa))), apply_to = function))
+        #define MUUID_TARGET_END MUUID_PRAGMA(clang attribute pop)
+    #else
+        #define MUUID_TARGET_BEGIN(isa) MUUID_PRAGMA(GCC push_options) MUUID_PRAGMA(GCC target(isa))
+        #define MUUID_TARGET_END MUUID_PRAGMA(GCC pop_options)
+    #endif
+
+    #define MUUID_TARGET_AVX2 "avx2"
+    #define MUUID_TARGET_AVX512 "avx512f,avx512vl"
+#endif
+
+namespace muuid::impl {
+
+    /// Instruction set tiers kernels can be compiled for. Higher values are better.
+    enum class cpu_tier : uint8_t {
+        generic,
+        sse2,
+        avx2,
+        avx512,
+        neon
+    };
+
+    /// The tier the library is compiled for without any dispatch
+    constexpr cpu_tier baseline_cpu_tier = 
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
+        cpu_tier::neon;
+    #elif defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        cpu_tier::sse2;
+    #else
+        cpu_tier::generic;
+    #endif
+
+    /**
+     * The best tier supported by this CPU
+     * 
+     * This can be lowered (but not raised) by setting MUUID_CPU_TIER environment variable
+     * to a tier name. Detection happens once on first call.
+     */
+    cpu_tier max_cpu_tier() noexcept;
+
+    auto cpu_tier_name(cpu_tier tier) noexcept -> std::string_view;
+
+    template<class Table>
+    struct kernel_variant {
+        cpu_tier tier;
+        const Table * table;
+    };
+
+    /// Selects the first variant supported by max_cpu_tier(). The variants must be ordered best first.
+    template<class Table, size_t N>
+    auto select_kernel(const kernel_variant<Table> (&variants)[N]) noexcept -> const kernel_variant<Table> & {
+        auto max = max_cpu_tier();
+        for (auto & variant: variants) {
+            if (variant.tier <= max)
+                return variant;
+        }
+        return variants[N - 1];
+    }
+}
+
+#endif
@@ -39,9 +39,21 @@ namespace {
             return std::span<const uint8_t, 16>(m_fingerprint, 16);
         }
 
+        //Fingerprint as 4 words, captured once per thread
+        const std::array<uint32_t, 4> & fast_key() {
+            if (!m_fast_key_ready) {
+                auto fp = this->fingerprint();
+                memcpy(m_fast_key.data(), fp.data(), fp.size());
+                m_fast_key_ready = true;
+            }
+            return m_fast_key;
+        }
+
     private:
         uint32_t m_counter;
         mutable uint8_t m_fingerprint[16];
+        std::array<uint32_t, 4> m_fast_key;
+        bool m_fast_key_ready = false;
     };
 
 }
@@ -50,45 +62,70 @@ static cuid2_state & get_state() {
     return impl::reset_on_fork_thread_local<cuid2_state>::instance();
 }
 
-auto cuid2::generate() -> cuid2 {
+//Random digits bytes are accepted if they represent a value not greater than max_digits.
+//Masking off bits above the highest bit of max_digits makes acceptance probability at least 1/2
+static bool accept_digits(std::span<uint8_t> digits, std::span<const uint8_t> max_digits) {
+    uint8_t mask = max_digits[0];
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    digits[0] &= mask;
+    return !std::lexicographical_compare(max_digits.begin(), max_digits.end(), digits.begin(), digits.end());
+}
+
+void impl::generate_cuid2(std::span<uint8_t> dest, std::span<const uint8_t> max_digits) {
     auto & gen = impl::get_random_generator();
 
     std::uniform_int_distribution<unsigned> first_letter_dist(0, 25);
-    auto first = uint8_t(first_letter_dist(gen));
-
-    auto time = system_clock::now().time_since_epoch().count();
+    dest[0] = uint8_t(first_letter_dist(gen));
+    auto digits = dest.subspan(1);
 
     auto & state = get_state();
-    uint32_t count = state.count();
     auto fingerprint = state.fingerprint();
-    
     std::uniform_int_distribution<uint32_t> salt_dist;
-    uint32_t salt[] = {salt_dist(gen), salt_dist(gen), salt_dist(gen), salt_dist(gen)};
-    
-    muuid_sha3_ctx ctx;
-    muuid_sha3_512_init(&ctx);
-    muuid_sha3_update(&ctx, (const unsigned char *)&time, sizeof(time));
-    muuid_sha3_update(&ctx, (const unsigned char *)salt, sizeof(salt));
-    muuid_sha3_update(&ctx, (const unsigned char *)&count, sizeof(count));
-    muuid_sha3_update(&ctx, (const unsigned char *)fingerprint.data(), fingerprint.size());
-
-    std::array<uint8_t, 64> hash;
-    muuid_sha3_final(&ctx, hash.data());
-
-    //we could do: impl::cuid2_repr repr_out(std::span<const uint8_t, 15>(&hash[1], 15));
-    //but there is no real reason to preserve byte order - it's just random
-    impl::cuid2_repr repr_out;
-    static_assert(sizeof(repr_out) <= hash.size() - 1);
-    memcpy(&repr_out, &hash[1], sizeof(repr_out));
-
-    impl::cuid2_repr repr_in;
-    for(size_t i = 0; i < char_length - 1; ++i) {
-        auto val = repr_out.pop_base36_digit();
-        repr_in.push_base36_digit(val);
+
+    for ( ; ; ) {
+        auto time = system_clock::now().time_since_epoch().count();
+        uint32_t count = state.count();
+        uint32_t salt[] = {salt_dist(gen), salt_dist(gen), salt_dist(gen), salt_dist(gen)};
+        
+        muuid_sha3_ctx ctx;
+        muuid_sha3_512_init(&ctx);
+        muuid_sha3_update(&ctx, (const unsigned char *)&time, sizeof(time));
+        muuid_sha3_update(&ctx, (const unsigned char *)salt, sizeof(salt));
+        muuid_sha3_update(&ctx, (const unsigned char *)&count, sizeof(count));
+        muuid_sha3_update(&ctx, (const unsigned char *)fingerprint.data(), fingerprint.size());
+
+        std::array<uint8_t, 64> hash;
+        muuid_sha3_final(&ctx, hash.data());
+
+        //there is no real reason to preserve byte order of the hash - it's just random
+        for (size_t offset = 1; offset + digits.size() <= hash.size(); offset += digits.size()) {
+            memcpy(digits.data(), &hash[offset], digits.size());
+            if (accept_digits(digits, max_digits))
+                return;
+        }
+    }
+}
+
+void impl::generate_cuid2_fast(std::span<uint8_t> dest, std::span<const uint8_t> max_digits) {
+    auto & gen = impl::get_random_generator();
+    auto & state = get_state();
+    auto & key = state.fast_key();
+
+    std::uniform_int_distribution<unsigned> first_letter_dist(0, 25);
+    const size_t size = max_digits.size() + 1;
+    for (size_t pos = 0; pos + size <= dest.size(); pos += size) {
+        dest[pos] = uint8_t(first_letter_dist(gen));
+        auto digits = dest.subspan(pos + 1, size - 1);
+        uint32_t count = state.count();
+        do {
+            //the keystream is uniform so XOR-ing it with the key and counter keeps it uniform
+            for (size_t i = 0; i < digits.size(); i += 4) {
+                uint32_t word = gen() ^ key[(i / 4) % key.size()] ^ (i == 0 ? count : 0);
+                for (size_t j = i; j < std::min(i + 4, digits.size()); ++j, word >>= 8)
+                    digits[j] = uint8_t(word);
+            }
+        } while (!accept_digits(digits, max_digits));
     }
-    
-    uint8_t ret[16];
-    ret[0] = first;
-    repr_in.get_bytes(std::span<uint8_t, 15>(&ret[1], 15));
-    return *reinterpret_cast<cuid2 *>(&ret);
 }
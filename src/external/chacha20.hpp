@@ -8,6 +8,7 @@
 #include <limits>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 
 namespace muuid::impl {
 
@@ -165,6 +166,30 @@ public:
 
         return block_[ index_++ ];
     }
+
+    // produces the same values as calling operator() for each
+    // element but copies whole blocks at a time
+    void generate( std::uint32_t * first, std::uint32_t * last ) noexcept
+    {
+        while( first != last )
+        {
+            if( index_ == 16 )
+            {
+                get_next_block();
+                index_ = 0;
+            }
+
+            std::size_t n = 16 - index_;
+            if( std::size_t( last - first ) < n )
+            {
+                n = std::size_t( last - first );
+            }
+
+            std::memcpy( first, block_ + index_, n * sizeof( std::uint32_t ) );
+            first += n;
+            index_ += n;
+        }
+    }
 };
 
 } // namespace
@@ -0,0 +1,44 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_KERNEL_HELPERS_H_INCLUDED
+#define HEADER_MODERN_UUID_KERNEL_HELPERS_H_INCLUDED
+
+//Helpers shared by the *_kernels_impl.h files. Like them this header is compiled once per 
+//instruction set tier so everything here has internal linkage. It must not include standard
+//headers since it is included after a target pragma. The ones it needs come from cpu_dispatch.h.
+
+#include "cpu_dispatch.h"
+
+namespace {
+
+    //Conversions between integers and doubles via the 2^52 bias trick. Targets below AVX-512DQ 
+    //have no SIMD instructions for 64-bit ones.
+    constexpr double bias = 4503599627370496.0; //2^52
+
+    //Exact for val < 2^52
+    inline double to_double(uint64_t val) {
+        return std::bit_cast<double>(val | std::bit_cast<uint64_t>(bias)) - bias;
+    }
+
+    //Truncates non-negative val < 2^52. Adding the bias rounds to nearest so we may need to step back.
+    inline uint64_t to_uint(double val) {
+        uint64_t ret = std::bit_cast<uint64_t>(val + bias) & ((uint64_t(1) << 52) - 1);
+        return ret - uint64_t(to_double(ret) > val);
+    }
+
+    //Compilers turn this into a single byte swapping load and vectorize it in loops
+    inline uint64_t load_be(const uint8_t * src) {
+        uint64_t ret = 0;
+        for (size_t i = 0; i < 8; ++i)
+            ret = (ret << 8) | src[i];
+        return ret;
+    }
+
+    inline void store_be(uint64_t val, uint8_t * dest) {
+        for (size_t i = 8; i-- > 0; val >>= 8)
+            dest[i] = uint8_t(val);
+    }
+}
+
+#endif
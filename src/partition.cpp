@@ -0,0 +1,104 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <modern-uuid/partition.h>
+
+#include "partition_kernels_impl.h"
+
+#include <numeric>
+#include <stdexcept>
+
+using namespace muuid;
+using namespace muuid::impl;
+
+const partition_kernels muuid::impl::partition_kernels_baseline = make_partition_kernels();
+
+auto muuid::impl::get_partition_kernels() noexcept -> const kernel_variant<partition_kernels> & {
+    static constexpr kernel_variant<partition_kernels> variants[] = {
+    #if MUUID_DISPATCH_X86
+        {cpu_tier::avx512, &partition_kernels_avx512},
+        {cpu_tier::avx2, &partition_kernels_avx2},
+    #endif
+        {baseline_cpu_tier, &partition_kernels_baseline}
+    };
+    static const kernel_variant<partition_kernels> & ret = select_kernel(variants);
+    return ret;
+}
+
+//Timestamps are 48-bit so larger periods are all the same
+static constexpr uint64_t g_max_period = uint64_t(1) << 48;
+
+template<class Id>
+static void partition(std::span<Id> ids, std::chrono::milliseconds period, std::vector<time_partition> & out,
+                      decltype(partition_kernels::uuid_timestamps) decode) {
+    if (period.count() <= 0)
+        MUUID_THROW(std::invalid_argument("partition period must be positive"));
+
+    out.clear();
+    const size_t size = ids.size();
+    if (size == 0)
+        return;
+
+    std::vector<uint64_t> timestamps(size);
+    uint64_t min, max;
+    decode(&ids.data()->bytes, timestamps.data(), size, min, max);
+    if (min == partition_kernels::no_timestamp)
+        return;
+
+    const uint64_t width = std::min(uint64_t(period.count()), g_max_period);
+    const uint64_t base = min - min % width;
+    const uint64_t period_count = (max - base) / width + 1;
+
+    std::vector<Id> sorted(size);
+    //Each element is (number of IDs before the period, period index). The last one is for IDs 
+    //without timestamps.
+    std::vector<std::pair<size_t, uint64_t>> starts;
+
+    if (period_count < std::max(size, size_t(4096)) && period_count < uint32_t(-1)) {
+        std::vector<uint32_t> indices(size);
+        get_partition_kernels().table->periods(timestamps.data(), base, width, uint32_t(period_count), 
+                                               indices.data(), size);
+        std::vector<size_t> offsets(period_count + 2, 0);
+        for (auto index: indices)
+            ++offsets[index + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        for (uint64_t i = 0; i <= period_count; ++i) {
+            if (offsets[i + 1] != offsets[i] || i == period_count)
+                starts.emplace_back(offsets[i], i);
+        }
+        for (size_t i = 0; i < size; ++i)
+            sorted[offsets[indices[i]]++] = ids[i];
+    } else {
+        std::vector<size_t> order(size);
+        std::iota(order.begin(), order.end(), size_t(0));
+        auto period_of = [&](size_t i) {
+            return timestamps[i] == partition_kernels::no_timestamp ? period_count : (timestamps[i] - base) / width;
+        };
+        std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return period_of(lhs) < period_of(rhs);
+        });
+        for (size_t i = 0; i < size; ++i) {
+            sorted[i] = ids[order[i]];
+            uint64_t current = period_of(order[i]);
+            if (starts.empty() || starts.back().second != current)
+                starts.emplace_back(i, current);
+        }
+        if (starts.back().second != period_count)
+            starts.emplace_back(size, period_count);
+    }
+
+    std::copy(sorted.begin(), sorted.end(), ids.begin());
+    out.reserve(starts.size() - 1);
+    for (size_t i = 0; i + 1 < starts.size(); ++i) {
+        auto start = time_partition::time_point_t(std::chrono::milliseconds(int64_t(base + starts[i].second * width)));
+        out.push_back({start, starts[i].first, starts[i + 1].first});
+    }
+}
+
+void muuid::partition_by_time(std::span<uuid> ids, std::chrono::milliseconds period, std::vector<time_partition> & out) {
+    partition(ids, period, out, get_partition_kernels().table->uuid_timestamps);
+}
+
+void muuid::partition_by_time(std::span<ulid> ids, std::chrono::milliseconds period, std::vector<time_partition> & out) {
+    partition(ids, period, out, get_partition_kernels().table->ulid_timestamps);
+}
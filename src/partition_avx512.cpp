@@ -0,0 +1,15 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//partition_by_time() kernels compiled for AVX-512
+#include "partition_kernels.h"
+
+#if MUUID_DISPATCH_X86
+
+MUUID_TARGET_BEGIN(MUUID_TARGET_AVX512)
+#include "partition_kernels_impl.h"
+MUUID_TARGET_END
+
+const muuid::impl::partition_kernels muuid::impl::partition_kernels_avx512 = make_partition_kernels();
+
+#endif
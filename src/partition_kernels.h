@@ -0,0 +1,39 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_PARTITION_KERNELS_H_INCLUDED
+#define HEADER_MODERN_UUID_PARTITION_KERNELS_H_INCLUDED
+
+#include "cpu_dispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace muuid::impl {
+
+    struct partition_kernels {
+        using block = std::array<uint8_t, 16>;
+
+        /// Timestamp value for IDs that have none
+        static constexpr uint64_t no_timestamp = uint64_t(-1);
+
+        /// Decodes millisecond timestamps and returns the smallest and largest of them in min and max
+        void (*uuid_timestamps)(const block * src, uint64_t * dest, size_t size, uint64_t & min, uint64_t & max) noexcept;
+        void (*ulid_timestamps)(const block * src, uint64_t * dest, size_t size, uint64_t & min, uint64_t & max) noexcept;
+        /// Computes `(timestamp - base) / period` or `none` for no_timestamp. Timestamps must be less than 2^48.
+        void (*periods)(const uint64_t * timestamps, uint64_t base, uint64_t period, uint32_t none, 
+                        uint32_t * dest, size_t size) noexcept;
+    };
+
+    extern const partition_kernels partition_kernels_baseline;
+#if MUUID_DISPATCH_X86
+    extern const partition_kernels partition_kernels_avx2;
+    extern const partition_kernels partition_kernels_avx512;
+#endif
+
+    auto get_partition_kernels() noexcept -> const kernel_variant<partition_kernels> &;
+}
+
+#endif
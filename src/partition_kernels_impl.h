@@ -0,0 +1,60 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Implementation of partition_by_time() kernels. This file is included by one translation unit per 
+//instruction set tier, each compiled for its tier. Everything here has internal linkage
+//so the copies compiled for different tiers cannot be mixed up by the linker.
+
+#include "partition_kernels.h"
+#include "kernel_helpers.h"
+
+//The loops below are simple element-wise operations that compilers turn into SIMD code.
+//Divisions are done in double precision which is exact for values below 2^48.
+
+namespace {
+
+    using block = muuid::impl::partition_kernels::block;
+    constexpr uint64_t no_timestamp = muuid::impl::partition_kernels::no_timestamp;
+
+    template<bool CheckUuid>
+    void timestamps(const block * src, uint64_t * dest, size_t size, uint64_t & min, uint64_t & max) noexcept {
+        uint64_t lowest = no_timestamp, highest = 0;
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t first = load_be(src[i].data());
+            uint64_t ts = first >> 16;
+            if constexpr (CheckUuid) {
+                //standard variant and version 7
+                const uint64_t valid = uint64_t((src[i][8] & 0xc0) == 0x80) & uint64_t(((first >> 12) & 0xf) == 7);
+                const uint64_t mask = uint64_t(0) - valid;
+                ts = (ts & mask) | (no_timestamp & ~mask);
+                highest = std::max(highest, ts & mask);
+            } else {
+                highest = std::max(highest, ts);
+            }
+            lowest = std::min(lowest, ts);
+            dest[i] = ts;
+        }
+        min = lowest;
+        max = highest;
+    }
+
+    void periods(const uint64_t * timestamps, uint64_t base, uint64_t period, uint32_t none, 
+                 uint32_t * dest, size_t size) noexcept {
+        const double divisor = to_double(period);
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t ts = timestamps[i];
+            //garbage for no_timestamp but it is replaced below
+            const uint64_t quotient = to_uint(to_double((ts - base) & ((uint64_t(1) << 52) - 1)) / divisor);
+            const uint64_t mask = uint64_t(0) - uint64_t(ts != no_timestamp);
+            dest[i] = uint32_t((quotient & mask) | (none & ~mask));
+        }
+    }
+
+    constexpr muuid::impl::partition_kernels make_partition_kernels() {
+        return {
+            timestamps<true>,
+            timestamps<false>,
+            periods
+        };
+    }
+}
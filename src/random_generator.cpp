@@ -1,6 +1,8 @@
 // Copyright (c) 2024, Eugene Gershnik
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include <modern-uuid/common.h>
+
 #include "random_generator.h"
 #include "fork_handler.h"
 
@@ -19,5 +21,16 @@ namespace muuid::impl {
         return reset_on_fork_thread_local<generator>::instance();
     }
 
+    auto get_process_hash_key() noexcept -> const std::array<uint64_t, 2> & {
+        static const std::array<uint64_t, 2> key = []() {
+            auto & gen = get_random_generator();
+            std::array<uint64_t, 2> ret;
+            for (auto & k: ret)
+                k = (uint64_t(gen()) << 32) | gen();
+            return ret;
+        }();
+        return key;
+    }
+
 }
 
@@ -0,0 +1,72 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <modern-uuid/set_operations.h>
+
+#include "set_operations_kernels_impl.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+using namespace muuid;
+using namespace muuid::impl;
+
+const set_operations_kernels muuid::impl::set_operations_kernels_baseline = make_set_operations_kernels();
+
+auto muuid::impl::get_set_operations_kernels() noexcept -> const kernel_variant<set_operations_kernels> & {
+    static constexpr kernel_variant<set_operations_kernels> variants[] = {
+    #if MUUID_DISPATCH_X86
+        {cpu_tier::avx512, &set_operations_kernels_avx512},
+        {cpu_tier::avx2, &set_operations_kernels_avx2},
+    #endif
+        {baseline_cpu_tier, &set_operations_kernels_baseline}
+    };
+    static const kernel_variant<set_operations_kernels> & ret = select_kernel(variants);
+    return ret;
+}
+
+template<class Id>
+static bool overlap(std::span<const Id> src, std::span<Id> dest) noexcept {
+    if (src.empty() || dest.empty())
+        return false;
+    std::less<const Id *> less;
+    return less(src.data(), dest.data() + dest.size()) && less(dest.data(), src.data() + src.size());
+}
+
+template<class Id>
+static size_t run(set_operations_kernels::func func, size_t required, 
+                  std::span<const Id> lhs, std::span<const Id> rhs, std::span<Id> dest) {
+    using block = set_operations_kernels::block;
+    if (dest.size() < required)
+        MUUID_THROW(std::invalid_argument("destination is too small"));
+    if (overlap(lhs, dest) || overlap(rhs, dest))
+        MUUID_THROW(std::invalid_argument("destination overlaps the inputs"));
+    return func(reinterpret_cast<const block *>(lhs.data()), lhs.size(), 
+                reinterpret_cast<const block *>(rhs.data()), rhs.size(), 
+                reinterpret_cast<block *>(dest.data()));
+}
+
+auto muuid::set_intersection(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->intersection, std::min(lhs.size(), rhs.size()), lhs, rhs, dest);
+}
+
+auto muuid::set_difference(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->difference, lhs.size(), lhs, rhs, dest);
+}
+
+auto muuid::set_union(std::span<const uuid> lhs, std::span<const uuid> rhs, std::span<uuid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->union_, lhs.size() + rhs.size(), lhs, rhs, dest);
+}
+
+auto muuid::set_intersection(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->intersection, std::min(lhs.size(), rhs.size()), lhs, rhs, dest);
+}
+
+auto muuid::set_difference(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->difference, lhs.size(), lhs, rhs, dest);
+}
+
+auto muuid::set_union(std::span<const ulid> lhs, std::span<const ulid> rhs, std::span<ulid> dest) -> size_t {
+    return run(get_set_operations_kernels().table->union_, lhs.size() + rhs.size(), lhs, rhs, dest);
+}
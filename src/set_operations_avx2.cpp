@@ -0,0 +1,15 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Set operations kernels compiled for AVX2
+#include "set_operations_kernels.h"
+
+#if MUUID_DISPATCH_X86
+
+MUUID_TARGET_BEGIN(MUUID_TARGET_AVX2)
+#include "set_operations_kernels_impl.h"
+MUUID_TARGET_END
+
+const muuid::impl::set_operations_kernels muuid::impl::set_operations_kernels_avx2 = make_set_operations_kernels();
+
+#endif
@@ -0,0 +1,33 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_SET_OPERATIONS_KERNELS_H_INCLUDED
+#define HEADER_MODERN_UUID_SET_OPERATIONS_KERNELS_H_INCLUDED
+
+#include "cpu_dispatch.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace muuid::impl {
+
+    struct set_operations_kernels {
+        using block = std::array<uint8_t, 16>;
+        using func = size_t (*)(const block * lhs, size_t lhs_size, const block * rhs, size_t rhs_size, block * dest) noexcept;
+
+        func intersection;
+        func difference;
+        func union_;
+    };
+
+    extern const set_operations_kernels set_operations_kernels_baseline;
+#if MUUID_DISPATCH_X86
+    extern const set_operations_kernels set_operations_kernels_avx2;
+    extern const set_operations_kernels set_operations_kernels_avx512;
+#endif
+
+    auto get_set_operations_kernels() noexcept -> const kernel_variant<set_operations_kernels> &;
+}
+
+#endif
@@ -0,0 +1,164 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Implementation of set operations kernels. This file is included by one translation unit per 
+//instruction set tier, each compiled for its tier. Everything here has internal linkage
+//so the copies compiled for different tiers cannot be mixed up by the linker.
+
+#include "set_operations_kernels.h"
+#include "kernel_helpers.h"
+
+//IDs are compared as pairs of big endian 64-bit words which gives the same order as byte-wise 
+//comparison. All the operations are merges. When the runs of elements in both ranges are short
+//each step is branch free so that the unpredictable comparison results cost no mispredictions.
+//When an element is less than the one `lanes` positions ahead in the other range the run is 
+//skipped with galloping search, finished by a SIMD comparison of a block of elements.
+
+namespace {
+
+    using block = muuid::impl::set_operations_kernels::block;
+
+    constexpr size_t lanes = 8;
+
+    struct key {
+        uint64_t high;
+        uint64_t low;
+    };
+
+    //Compilers recognize this as a load followed by a byte swap
+    inline key load(const block & src) {
+        return {load_be(src.data()), load_be(src.data() + 8)};
+    }
+
+    inline bool less(const key & lhs, const key & rhs) {
+        return (lhs.high < rhs.high) | ((lhs.high == rhs.high) & (lhs.low < rhs.low));
+    }
+
+    //Number of elements in a block of `lanes` that are less than val. Compiled into SIMD comparisons.
+    inline size_t count_less(const block * src, const key & val) {
+        size_t ret = 0;
+        for (size_t i = 0; i < lanes; ++i)
+            ret += less(load(src[i]), val);
+        return ret;
+    }
+
+    //Whether the first `lanes + 1` elements of a sorted range are all less than val. Only compares
+    //the high words which is cheaper and only misses runs ending in elements with equal high words.
+    inline bool long_run(const block * src, size_t size, const key & val) {
+        return size > lanes && load_be(src[lanes].data()) < val.high;
+    }
+
+    //Returns the number of leading elements of a sorted range that are less than val. 
+    //Must only be called when long_run() is true.
+    inline size_t skip(const block * src, size_t size, const key & val) {
+        //src[lo - 1] < val and src[hi] >= val unless hi == size
+        size_t lo = lanes + 1, hi;
+        for (size_t step = lanes; ; step *= 2) {
+            hi = lo + step;
+            if (hi >= size) {
+                hi = size;
+                break;
+            }
+            if (!less(load(src[hi]), val))
+                break;
+            lo = hi + 1;
+        }
+        while (hi - lo > lanes) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (less(load(src[mid]), val))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        //all elements before hi - lanes are less than val
+        return hi - lanes + count_less(src + hi - lanes, val);
+    }
+
+    size_t intersection(const block * lhs, size_t lhs_size, const block * rhs, size_t rhs_size, block * dest) noexcept {
+        size_t i = 0, j = 0, ret = 0;
+        while (i < lhs_size && j < rhs_size) {
+            const key left = load(lhs[i]);
+            const key right = load(rhs[j]);
+            if (long_run(lhs + i, lhs_size - i, right)) {
+                i += skip(lhs + i, lhs_size - i, right);
+                continue;
+            }
+            if (long_run(rhs + j, rhs_size - j, left)) {
+                j += skip(rhs + j, rhs_size - j, left);
+                continue;
+            }
+            const bool lt = less(left, right), gt = less(right, left);
+            dest[ret] = lhs[i];
+            ret += !(lt | gt);
+            i += !gt;
+            j += !lt;
+        }
+        return ret;
+    }
+
+    size_t difference(const block * lhs, size_t lhs_size, const block * rhs, size_t rhs_size, block * dest) noexcept {
+        size_t i = 0, j = 0, ret = 0;
+        while (i < lhs_size && j < rhs_size) {
+            const key left = load(lhs[i]);
+            const key right = load(rhs[j]);
+            if (long_run(lhs + i, lhs_size - i, right)) {
+                size_t count = skip(lhs + i, lhs_size - i, right);
+                memcpy(dest + ret, lhs + i, count * sizeof(block));
+                ret += count;
+                i += count;
+                continue;
+            }
+            if (long_run(rhs + j, rhs_size - j, left)) {
+                j += skip(rhs + j, rhs_size - j, left);
+                continue;
+            }
+            const bool lt = less(left, right), gt = less(right, left);
+            dest[ret] = lhs[i];
+            ret += lt;
+            i += !gt;
+            j += !lt;
+        }
+        memcpy(dest + ret, lhs + i, (lhs_size - i) * sizeof(block));
+        return ret + (lhs_size - i);
+    }
+
+    size_t union_(const block * lhs, size_t lhs_size, const block * rhs, size_t rhs_size, block * dest) noexcept {
+        size_t i = 0, j = 0, ret = 0;
+        while (i < lhs_size && j < rhs_size) {
+            const key left = load(lhs[i]);
+            const key right = load(rhs[j]);
+            if (long_run(lhs + i, lhs_size - i, right)) {
+                size_t count = skip(lhs + i, lhs_size - i, right);
+                memcpy(dest + ret, lhs + i, count * sizeof(block));
+                ret += count;
+                i += count;
+                continue;
+            }
+            if (long_run(rhs + j, rhs_size - j, left)) {
+                size_t count = skip(rhs + j, rhs_size - j, left);
+                memcpy(dest + ret, rhs + j, count * sizeof(block));
+                ret += count;
+                j += count;
+                continue;
+            }
+            const bool lt = less(left, right), gt = less(right, left);
+            //select the smaller element without a branch
+            const uintptr_t mask = uintptr_t(0) - gt;
+            dest[ret++] = *reinterpret_cast<const block *>((uintptr_t(lhs + i) & ~mask) | (uintptr_t(rhs + j) & mask));
+            i += !gt;
+            j += !lt;
+        }
+        memcpy(dest + ret, lhs + i, (lhs_size - i) * sizeof(block));
+        ret += lhs_size - i;
+        memcpy(dest + ret, rhs + j, (rhs_size - j) * sizeof(block));
+        return ret + (rhs_size - j);
+    }
+
+    constexpr muuid::impl::set_operations_kernels make_set_operations_kernels() {
+        return {
+            intersection,
+            difference,
+            union_
+        };
+    }
+}
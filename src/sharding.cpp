@@ -0,0 +1,40 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <modern-uuid/sharding.h>
+
+#include "sharding_kernels_impl.h"
+
+using namespace muuid;
+using namespace muuid::impl;
+
+const sharding_kernels muuid::impl::sharding_kernels_baseline = make_sharding_kernels();
+
+auto muuid::impl::get_sharding_kernels() noexcept -> const kernel_variant<sharding_kernels> & {
+    static constexpr kernel_variant<sharding_kernels> variants[] = {
+    #if MUUID_DISPATCH_X86
+        {cpu_tier::avx512, &sharding_kernels_avx512},
+        {cpu_tier::avx2, &sharding_kernels_avx2},
+    #endif
+        {baseline_cpu_tier, &sharding_kernels_baseline}
+    };
+    static const kernel_variant<sharding_kernels> & ret = select_kernel(variants);
+    return ret;
+}
+
+void muuid::impl::shard_keys_bulk(const uuid * src, uint64_t * dest, size_t size) noexcept {
+    get_sharding_kernels().table->uuid_keys(&src->bytes, dest, size);
+}
+
+void muuid::impl::shard_keys_bulk(const ulid * src, uint64_t * dest, size_t size) noexcept {
+    get_sharding_kernels().table->ulid_keys(&src->bytes, dest, size);
+}
+
+void muuid::impl::jump_hash_bulk(const uint64_t * keys, uint32_t count, uint32_t * dest, size_t size) noexcept {
+    get_sharding_kernels().table->jump_hash(keys, count, dest, size);
+}
+
+void muuid::impl::rendezvous_bulk(const uint64_t * keys, const uint64_t * shards, size_t shard_count,
+                                  uint32_t * dest, size_t size) noexcept {
+    get_sharding_kernels().table->rendezvous(keys, shards, shard_count, dest, size);
+}
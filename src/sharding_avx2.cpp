@@ -0,0 +1,15 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Sharding kernels compiled for AVX2
+#include "sharding_kernels.h"
+
+#if MUUID_DISPATCH_X86
+
+MUUID_TARGET_BEGIN(MUUID_TARGET_AVX2)
+#include "sharding_kernels_impl.h"
+MUUID_TARGET_END
+
+const muuid::impl::sharding_kernels muuid::impl::sharding_kernels_avx2 = make_sharding_kernels();
+
+#endif
@@ -0,0 +1,33 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef HEADER_MODERN_UUID_SHARDING_KERNELS_H_INCLUDED
+#define HEADER_MODERN_UUID_SHARDING_KERNELS_H_INCLUDED
+
+#include "cpu_dispatch.h"
+
+#include <array>
+#include <bit>
+
+namespace muuid::impl {
+
+    struct sharding_kernels {
+        using block = std::array<uint8_t, 16>;
+
+        void (*uuid_keys)(const block * src, uint64_t * dest, size_t size) noexcept;
+        void (*ulid_keys)(const block * src, uint64_t * dest, size_t size) noexcept;
+        void (*jump_hash)(const uint64_t * keys, uint32_t count, uint32_t * dest, size_t size) noexcept;
+        void (*rendezvous)(const uint64_t * keys, const uint64_t * shards, size_t shard_count, 
+                           uint32_t * dest, size_t size) noexcept;
+    };
+
+    extern const sharding_kernels sharding_kernels_baseline;
+#if MUUID_DISPATCH_X86
+    extern const sharding_kernels sharding_kernels_avx2;
+    extern const sharding_kernels sharding_kernels_avx512;
+#endif
+
+    auto get_sharding_kernels() noexcept -> const kernel_variant<sharding_kernels> &;
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Implementation of sharding kernels. This file is included by one translation unit per 
+//instruction set tier, each compiled for its tier. Everything here has internal linkage
+//so the copies compiled for different tiers cannot be mixed up by the linker.
+
+#include "sharding_kernels.h"
+#include "kernel_helpers.h"
+
+//The kernels below process N IDs or keys at a time. The jump hash loop runs until all N lanes 
+//are done with finished lanes left unchanged via selects rather than branches. All the values 
+//converted between integers and doubles are less than 2^33 so the results are exactly the same 
+//as of impl::jump_hash().
+
+namespace {
+
+    //With fewer lanes GCC fully unrolls the jump hash step and then finds SLP vectorization 
+    //of the result unprofitable
+    constexpr size_t lanes = 16;
+
+    inline uint64_t mix(uint64_t val) {
+        val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9;
+        val = (val ^ (val >> 27)) * 0x94d049bb133111eb;
+        return val ^ (val >> 31);
+    }
+
+    template<class Src, class Dest, class Kernel>
+    inline void for_each_block(const Src * src, Dest * dest, size_t size, Kernel kernel) {
+        size_t i = 0;
+        for ( ; size - i >= lanes; i += lanes)
+            kernel.template operator()<lanes>(src + i, dest + i);
+        for ( ; i < size; ++i)
+            kernel.template operator()<1>(src + i, dest + i);
+    }
+
+    //A plain load on little endian hosts lets the compiler see the interleaved access pattern
+    inline uint64_t load_le(const uint8_t * src) {
+        uint64_t ret = 0;
+        if constexpr (std::endian::native == std::endian::little) {
+            memcpy(&ret, src, sizeof(ret));
+        } else {
+            for (size_t i = 8; i > 0; --i)
+                ret = (ret << 8) | src[i - 1];
+        }
+        return ret;
+    }
+
+    using block = std::array<uint8_t, 16>;
+
+    //Same as impl::shard_key() for uuid if CheckUuid is true and for ulid otherwise. 
+    //Both the folded and mixed keys are computed and one of them selected without branching.
+    template<bool CheckUuid>
+    void keys(const block * src, uint64_t * dest, size_t size) noexcept {
+        for_each_block(src, dest, size, []<size_t N>(const block * s, uint64_t * d) {
+            for (size_t i = 0; i < N; ++i) {
+                const uint64_t first = load_le(s[i].data());
+                const uint64_t last = load_le(s[i].data() + 8);
+                const uint64_t mixed = mix(mix(first) ^ last);
+                if constexpr (CheckUuid) {
+                    //standard variant and version 3, 4 or 5
+                    const uint64_t version = (first >> 52) & 0xf;
+                    const uint64_t uniform = uint64_t((last & 0xc0) == 0x80) & 
+                                             uint64_t(version - 3 < 3);
+                    const uint64_t mask = uint64_t(0) - uniform;
+                    d[i] = ((first ^ last) & mask) | (mixed & ~mask);
+                } else {
+                    d[i] = mixed;
+                }
+            }
+        });
+    }
+
+    void jump_hash(const uint64_t * keys, uint32_t count, uint32_t * dest, size_t size) noexcept {
+        const double limit = double(count);
+        for_each_block(keys, dest, size, [limit]<size_t N>(const uint64_t * k, uint32_t * d) {
+            uint64_t key[N], ret[N];
+            double next[N];
+            for (size_t i = 0; i < N; ++i) {
+                key[i] = k[i];
+                ret[i] = 0;
+                next[i] = 0;
+            }
+            for ( ; ; ) {
+                uint64_t active = 0;
+                for (size_t i = 0; i < N; ++i)
+                    active |= uint64_t(next[i] < limit);
+                if (!active)
+                    break;
+                for (size_t i = 0; i < N; ++i) {
+                    const uint64_t mask = uint64_t(0) - uint64_t(next[i] < limit);
+                    const uint64_t new_ret = to_uint(next[i]);
+                    const uint64_t new_key = key[i] * 2862933555777941757 + 1;
+                    const double new_next = to_double(new_ret + 1) * (double(uint64_t(1) << 31) / to_double((new_key >> 33) + 1));
+                    ret[i] = (new_ret & mask) | (ret[i] & ~mask);
+                    key[i] = (new_key & mask) | (key[i] & ~mask);
+                    next[i] = std::bit_cast<double>((std::bit_cast<uint64_t>(new_next) & mask) | 
+                                                    (std::bit_cast<uint64_t>(next[i]) & ~mask));
+                }
+            }
+            for (size_t i = 0; i < N; ++i)
+                d[i] = uint32_t(ret[i]);
+        });
+    }
+
+    void rendezvous(const uint64_t * keys, const uint64_t * shards, size_t shard_count, 
+                    uint32_t * dest, size_t size) noexcept {
+        if (shard_count == 0) {
+            for (size_t i = 0; i < size; ++i)
+                dest[i] = 0;
+            return;
+        }
+        for_each_block(keys, dest, size, [shards, shard_count]<size_t N>(const uint64_t * k, uint32_t * d) {
+            uint64_t best[N], ret[N];
+            const uint64_t first = mix(shards[0]);
+            for (size_t i = 0; i < N; ++i) {
+                best[i] = mix(k[i] ^ first);
+                ret[i] = 0;
+            }
+            for (size_t s = 1; s < shard_count; ++s) {
+                const uint64_t shard = mix(shards[s]);
+                for (size_t i = 0; i < N; ++i) {
+                    const uint64_t score = mix(k[i] ^ shard);
+                    const uint64_t mask = uint64_t(0) - uint64_t(score > best[i]);
+                    best[i] = (score & mask) | (best[i] & ~mask);
+                    ret[i] = (s & mask) | (ret[i] & ~mask);
+                }
+            }
+            for (size_t i = 0; i < N; ++i)
+                d[i] = uint32_t(ret[i]);
+        });
+    }
+
+    constexpr muuid::impl::sharding_kernels make_sharding_kernels() {
+        return {
+            keys<true>,
+            keys<false>,
+            jump_hash,
+            rendezvous
+        };
+    }
+}
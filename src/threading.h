@@ -9,6 +9,7 @@
 #if MUUID_MULTITHREADED
     #include <atomic>
     #include <mutex>
+    #include <thread>
 #endif
 
 
@@ -30,38 +31,84 @@ namespace muuid::impl {
             T get() { return this->m_value.load(std::memory_order_acquire); }
             void set(T val) { this->m_value.store(val, std::memory_order_release); }
             T exchange(T val) { return this->m_value.exchange(val, std::memory_order_acq_rel); }
+            T fetch_add(T val) { return this->m_value.fetch_add(val, std::memory_order_acq_rel); }
+            bool compare_exchange(T & expected, T desired) { 
+                return this->m_value.compare_exchange_strong(expected, desired, 
+                                                             std::memory_order_acq_rel, std::memory_order_acquire); 
+            }
         private:
             std::atomic<T> m_value;
         };
 
-        class spinlock_if_multithreaded {
+        //A lock for very short critical sections. It spins for a little while and, if
+        //the holder still hasn't released it (e.g. because it was preempted), parks the 
+        //waiting thread in the OS rather than burning its scheduling quantum.
+        //This is the classic 3-state futex mutex: 0 - unlocked, 1 - locked, 2 - locked 
+        //and there might be parked waiters.
+        class adaptive_lock_if_multithreaded {
         public:
             void lock() noexcept 
             {
-                for ( ; ; ) {
-                    
-                    while (m_value.load(std::memory_order_relaxed)) 
-                        yield();
-                    
-                    unsigned current = 0;
-                    if (m_value.compare_exchange_strong(current, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                unsigned current = s_unlocked;
+                if (m_value.compare_exchange_strong(current, s_locked, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                lock_contended();
+            }
+
+            void unlock() noexcept 
+            {
+                if (m_value.exchange(s_unlocked, std::memory_order_release) == s_contended)
+                    wake();
+            }
+
+        private:
+            void lock_contended() noexcept {
+                for (unsigned i = 0; i < s_spin_count; ++i) {
+                    unsigned current = m_value.load(std::memory_order_relaxed);
+                    if (current == s_contended)
+                        break;
+                    if (current == s_unlocked && 
+                        m_value.compare_exchange_weak(current, s_locked, std::memory_order_acquire, std::memory_order_relaxed))
                         return;
-                
                     yield();
                 }
+
+                //If we acquire it here we must keep it marked as contended since we cannot
+                //know whether there are other parked waiters
+                while (m_value.exchange(s_contended, std::memory_order_acquire) != s_unlocked)
+                    park();
             }
 
-            void unlock() noexcept 
-                { m_value.store(0, std::memory_order_release); }
+            void park() noexcept {
+                #if __cpp_lib_atomic_wait >= 201907L
+                    m_value.wait(s_contended, std::memory_order_relaxed);
+                #else
+                    std::this_thread::yield();
+                #endif
+            }
+
+            void wake() noexcept {
+                #if __cpp_lib_atomic_wait >= 201907L
+                    m_value.notify_one();
+                #endif
+            }
 
-        private:
             static void yield() noexcept {
                 #ifdef MUUID_THREAD_YIELD
                     MUUID_THREAD_YIELD;
                 #endif
             }
         private:
-            std::atomic<unsigned> m_value{0};
+            static constexpr unsigned s_unlocked = 0;
+            static constexpr unsigned s_locked = 1;
+            static constexpr unsigned s_contended = 2;
+
+            //Roughly a few microseconds with pause instructions. Critical sections
+            //protected by this lock are a handful of instructions so if the lock is
+            //still held after that the holder is almost certainly not running.
+            static constexpr unsigned s_spin_count = 100;
+
+            std::atomic<unsigned> m_value{s_unlocked};
         };
 
         using mutex_if_multithreaded = std::mutex;
@@ -132,11 +179,24 @@ namespace muuid::impl {
                 m_value = val;
                 return ret;
             }
+            T fetch_add(T val) {
+                T ret = m_value;
+                m_value += val;
+                return ret;
+            }
+            bool compare_exchange(T & expected, T desired) {
+                if (m_value != expected) {
+                    expected = m_value;
+                    return false;
+                }
+                m_value = desired;
+                return true;
+            }
         private:
             T m_value;
         };
 
-        class spinlock_if_multithreaded {
+        class adaptive_lock_if_multithreaded {
         public:
             void lock() noexcept {}
             void unlock() noexcept {}
@@ -4,12 +4,13 @@
 #include <modern-uuid/ulid.h>
 
 #include "clocks.h"
+#include "random_generator.h"
 
 
 using namespace muuid;
 
-auto ulid::generate() -> ulid {
-    auto [clock, tail_low, tail_high] = impl::get_clock_ulid();
+static inline auto make_ordered(const impl::clock_result_ulid & clock_result) -> ulid {
+    auto [clock, tail_low, tail_high] = clock_result;
     uint32_t time_high = uint32_t(clock >> 16);
     uint16_t time_low = uint16_t(clock);
     std::array<uint8_t, 16> buf;
@@ -22,3 +23,76 @@ auto ulid::generate() -> ulid {
     ulid * ret = reinterpret_cast<ulid *>(&buf);
     return *ret;
 }
+
+auto ulid::generate() -> ulid {
+    return make_ordered(impl::get_clock_ulid());
+}
+
+void ulid::generate_into(void * dest, size_t stride, size_t count) {
+    constexpr size_t batch = 64;
+    impl::clock_result_ulid clocks[batch];
+    auto * out = static_cast<uint8_t *>(dest);
+    for (size_t done = 0; done < count; ) {
+        const size_t size = std::min(count - done, batch);
+        impl::get_clock_ulid(clocks, size);
+        for (size_t i = 0; i < size; ++i, out += stride) {
+            auto id = make_ordered(clocks[i]);
+            memcpy(out, id.bytes.data(), id.bytes.size());
+        }
+        done += size;
+    }
+}
+
+static inline auto make_unordered(uint64_t clock, uint16_t random_high, uint32_t random_mid, uint32_t random_low) -> ulid {
+    uint32_t time_high = uint32_t(clock >> 16);
+    uint16_t time_low = uint16_t(clock);
+    std::array<uint8_t, 16> buf;
+    auto data = buf.data();
+    data = impl::write_bytes(time_high, data);
+    data = impl::write_bytes(time_low, data);
+    data = impl::write_bytes(random_high, data);
+    data = impl::write_bytes(random_mid, data);
+    data = impl::write_bytes(random_low, data);
+
+    ulid * ret = reinterpret_cast<ulid *>(&buf);
+    return *ret;
+}
+
+auto ulid::generate_unordered() -> ulid {
+    auto clock = impl::get_clock_ulid_unordered();
+    auto & gen = impl::get_random_generator();
+    uint32_t r0 = gen(), r1 = gen(), r2 = gen();
+    return make_unordered(clock, uint16_t(r0), r1, r2);
+}
+
+void ulid::generate_unordered(std::span<ulid> dest) {
+    ulid::generate_unordered_into(dest.data(), sizeof(ulid), dest.size());
+}
+
+void ulid::generate_unordered_into(void * dest, size_t stride, size_t count) {
+    constexpr size_t batch = 64;
+    //2 ULIDs need 160 random bits - exactly 5 generator outputs
+    uint32_t words[batch / 2 * 5 + 1];
+    auto clock = impl::get_clock_ulid_unordered();
+    auto & gen = impl::get_random_generator();
+    auto * out = static_cast<uint8_t *>(dest);
+    for (size_t done = 0; done < count; ) {
+        const size_t size = std::min(count - done, batch);
+        gen.generate(words, words + size / 2 * 5 + (size % 2) * 3);
+        const uint32_t * random = words;
+        size_t i = 0;
+        for ( ; i + 1 < size; i += 2, random += 5) {
+            auto first = make_unordered(clock, uint16_t(random[0]), random[1], random[2]);
+            auto second = make_unordered(clock, uint16_t(random[0] >> 16), random[3], random[4]);
+            memcpy(out, first.bytes.data(), first.bytes.size());
+            memcpy(out + stride, second.bytes.data(), second.bytes.size());
+            out += 2 * stride;
+        }
+        if (i < size) {
+            auto id = make_unordered(clock, uint16_t(random[0]), random[1], random[2]);
+            memcpy(out, id.bytes.data(), id.bytes.size());
+            out += stride;
+        }
+        done += size;
+    }
+}
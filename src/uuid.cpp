@@ -29,6 +29,24 @@ auto uuid::generate_random() noexcept -> uuid {
     return *ret;
 }
 
+void uuid::generate_random_into(void * dest, size_t stride, size_t count) noexcept {
+    constexpr size_t batch = 64;
+    uint32_t words[batch * 4];
+    auto & gen = impl::get_random_generator();
+    auto * out = static_cast<uint8_t *>(dest);
+    for (size_t done = 0; done < count; ) {
+        const size_t size = std::min(count - done, batch);
+        gen.generate(words, words + size * 4);
+        for (size_t i = 0; i < size; ++i, out += stride) {
+            auto * bytes = reinterpret_cast<uint8_t *>(words + i * 4);
+            bytes[8] = (bytes[8] & 0x3F) | 0x80;
+            bytes[6] = (bytes[6] & 0x0F) | 0x40;
+            memcpy(out, bytes, sizeof(uuid));
+        }
+        done += size;
+    }
+}
+
 auto uuid::generate_md5(uuid ns, std::string_view name) noexcept -> uuid {
     
     static_assert(sizeof(uuid) == MUUID_MD5LENGTH);
@@ -106,8 +124,8 @@ auto uuid::generate_reordered_time_based() -> uuid {
     return uuid(parts);
 }
 
-auto uuid::generate_unix_time_based() -> uuid {  
-    auto [clock, extra, clock_seq] = impl::get_clock_v7();
+static auto make_unix_time_based(const impl::clock_result_v7 & clock_result, uint16_t random_high, uint32_t random_low) -> uuid {
+    auto [clock, extra, clock_seq, clock_seq_ext, has_clock_seq_ext] = clock_result;
 
     uuid_parts parts;
     parts.time_low = uint32_t(clock >> 16);
@@ -115,12 +133,44 @@ auto uuid::generate_unix_time_based() -> uuid {
     parts.time_hi_and_version = (extra & 0x0FFF) | 0x7000;
     parts.clock_seq = clock_seq | 0x8000;
     
-    auto & gen = impl::get_random_generator();
-    std::uniform_int_distribution<unsigned> distrib(0, 255);
-    for (auto & b: parts.node)
-        b = uint8_t(distrib(gen));
+    auto * node = impl::write_bytes(has_clock_seq_ext ? clock_seq_ext : random_high, parts.node);
+    impl::write_bytes(random_low, node);
     
     return uuid(parts);
 }
 
+auto uuid::generate_unix_time_based() -> uuid {  
+    auto clock = impl::get_clock_v7();
+    auto & gen = impl::get_random_generator();
+    uint32_t r0 = gen(), r1 = gen();
+    return make_unix_time_based(clock, uint16_t(r0), r1);
+}
 
+void uuid::generate_unix_time_based_into(void * dest, size_t stride, size_t count) {
+    constexpr size_t batch = 64;
+    impl::clock_result_v7 clocks[batch];
+    //2 UUIDs need 96 random bits - exactly 3 generator outputs
+    uint32_t words[batch / 2 * 3 + 1];
+    auto & gen = impl::get_random_generator();
+    auto * out = static_cast<uint8_t *>(dest);
+    for (size_t done = 0; done < count; ) {
+        const size_t size = std::min(count - done, batch);
+        impl::get_clock_v7(clocks, size);
+        gen.generate(words, words + size / 2 * 3 + (size % 2) * 2);
+        const uint32_t * random = words;
+        size_t i = 0;
+        for ( ; i + 1 < size; i += 2, random += 3) {
+            auto first = make_unix_time_based(clocks[i], uint16_t(random[0]), random[1]);
+            auto second = make_unix_time_based(clocks[i + 1], uint16_t(random[0] >> 16), random[2]);
+            memcpy(out, first.bytes.data(), first.bytes.size());
+            memcpy(out + stride, second.bytes.data(), second.bytes.size());
+            out += 2 * stride;
+        }
+        if (i < size) {
+            auto id = make_unix_time_based(clocks[i], uint16_t(random[0]), random[1]);
+            memcpy(out, id.bytes.data(), id.bytes.size());
+            out += stride;
+        }
+        done += size;
+    }
+}
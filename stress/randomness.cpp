@@ -0,0 +1,483 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Statistical quality checks of generator outputs.
+//
+//Random parts of generated IDs are fed into a set of classic tests:
+//* bit bias - frequency of ones at every random bit position
+//* symbol frequency - chi-square of every character position and of adjacent character pairs
+//  (for string IDs whose alphabets are not powers of 2)
+//* birthday spacings - duplicate spacings among 512 24-bit "birthdays" follow Poisson(2)
+//* gap - distances between 32-bit values falling into the lowest 1/16 of the range are geometric
+//
+//Every statistic is converted to a normal z-score and a test fails if |z| exceeds the threshold.
+//Statistics are accumulated per thread and merged so the run scales with available cores.
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace muuid;
+
+namespace {
+
+    MUUID_DECLARE_NANOID_ALPHABET(base36_alphabet, "0123456789abcdefghijklmnopqrstuvwxyz");
+    MUUID_DECLARE_NANOID_ALPHABET(digits_alphabet, "0123456789");
+
+    using nanoid36 = basic_nanoid<base36_alphabet, 24>;
+    using nanoid10 = basic_nanoid<digits_alphabet, 16>;
+
+    double g_threshold = 5;
+
+    using record = std::array<uint8_t, 16>;
+
+    //Wilson-Hilferty approximation of chi-square to normal
+    auto chi_square_z(double chi2, double df) -> double {
+        double v = 2 / (9 * df);
+        return (std::cbrt(chi2 / df) - (1 - v)) / std::sqrt(v);
+    }
+
+    auto chi_square(const uint64_t * observed, const double * expected, size_t count) -> double {
+        double ret = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double diff = double(observed[i]) - expected[i];
+            ret += diff * diff / expected[i];
+        }
+        return ret;
+    }
+
+    bool report(const char * test, double z, const std::string & details) {
+        bool ok = std::abs(z) <= g_threshold;
+        std::printf("  %-18s z: %7.2f  %-40s %s\n", test, z, details.c_str(), ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //Extracts 32-bit words from the random bits of a sequence of records
+    class word_stream {
+    public:
+        word_stream(const record & random_mask) {
+            for (size_t i = 0; i < random_mask.size() * 8; ++i) {
+                if (random_mask[i / 8] & (0x80 >> (i % 8)))
+                    m_positions.push_back(uint8_t(i));
+            }
+        }
+
+        template<class Func>
+        void feed(const record & rec, Func && on_word) {
+            for (auto pos: m_positions) {
+                m_acc = (m_acc << 1) | ((rec[pos / 8] >> (7 - pos % 8)) & 1);
+                if (++m_bits == 32) {
+                    on_word(uint32_t(m_acc));
+                    m_bits = 0;
+                }
+            }
+        }
+    private:
+        std::vector<uint8_t> m_positions;
+        uint64_t m_acc = 0;
+        unsigned m_bits = 0;
+    };
+
+    class bit_bias_test {
+    public:
+        void add(const record & rec) {
+            for (size_t i = 0; i < 128; ++i)
+                m_ones[i] += (rec[i / 8] >> (7 - i % 8)) & 1;
+            ++m_count;
+        }
+        void merge(const bit_bias_test & other) {
+            for (size_t i = 0; i < 128; ++i)
+                m_ones[i] += other.m_ones[i];
+            m_count += other.m_count;
+        }
+        bool evaluate(const record & random_mask) const {
+            double worst = 0;
+            size_t worst_pos = 0;
+            for (size_t i = 0; i < 128; ++i) {
+                if (!(random_mask[i / 8] & (0x80 >> (i % 8))))
+                    continue;
+                double z = (double(m_ones[i]) - double(m_count) / 2) / std::sqrt(double(m_count) / 4);
+                if (std::abs(z) > std::abs(worst)) {
+                    worst = z;
+                    worst_pos = i;
+                }
+            }
+            return report("bit bias", worst, "worst at bit " + std::to_string(worst_pos));
+        }
+    private:
+        uint64_t m_ones[128] = {};
+        uint64_t m_count = 0;
+    };
+
+    class birthday_spacing_test {
+    public:
+        static constexpr size_t birthdays = 512;
+        static constexpr unsigned day_bits = 24;
+        static constexpr double lambda = double(birthdays) * birthdays * birthdays / (4.0 * (1u << day_bits));
+        static constexpr size_t bins = 8;
+
+        void add(uint32_t word) {
+            m_days[m_filled++] = word >> (32 - day_bits);
+            if (m_filled < birthdays)
+                return;
+            m_filled = 0;
+            std::sort(m_days.begin(), m_days.end());
+            std::array<uint32_t, birthdays> spacings;
+            spacings[0] = m_days[0];
+            for (size_t i = 1; i < birthdays; ++i)
+                spacings[i] = m_days[i] - m_days[i - 1];
+            std::sort(spacings.begin(), spacings.end());
+            size_t duplicates = 0;
+            for (size_t i = 1; i < birthdays; ++i)
+                duplicates += (spacings[i] == spacings[i - 1]);
+            ++m_histogram[std::min(duplicates, bins - 1)];
+        }
+        void merge(const birthday_spacing_test & other) {
+            for (size_t i = 0; i < bins; ++i)
+                m_histogram[i] += other.m_histogram[i];
+        }
+        bool evaluate() const {
+            uint64_t trials = 0;
+            for (auto count: m_histogram)
+                trials += count;
+            double expected[bins];
+            double p = std::exp(-lambda);
+            double remaining = 1;
+            for (size_t i = 0; i < bins - 1; ++i) {
+                expected[i] = p * double(trials);
+                remaining -= p;
+                p *= lambda / double(i + 1);
+            }
+            expected[bins - 1] = remaining * double(trials);
+            double chi2 = chi_square(m_histogram, expected, bins);
+            return report("birthday spacing", chi_square_z(chi2, bins - 1),
+                          std::to_string(trials) + " trials");
+        }
+    private:
+        std::array<uint32_t, birthdays> m_days;
+        size_t m_filled = 0;
+        uint64_t m_histogram[bins] = {};
+    };
+
+    class gap_test {
+    public:
+        static constexpr unsigned hit_bits = 4;
+        static constexpr size_t bins = 128;
+
+        void add(uint32_t word) {
+            if ((word >> (32 - hit_bits)) != 0) {
+                ++m_gap;
+                return;
+            }
+            ++m_histogram[std::min<uint64_t>(m_gap, bins - 1)];
+            m_gap = 0;
+        }
+        void merge(const gap_test & other) {
+            for (size_t i = 0; i < bins; ++i)
+                m_histogram[i] += other.m_histogram[i];
+        }
+        bool evaluate() const {
+            uint64_t gaps = 0;
+            for (auto count: m_histogram)
+                gaps += count;
+            double hit = 1.0 / (1u << hit_bits);
+            double expected[bins];
+            double p = hit;
+            for (size_t i = 0; i < bins - 1; ++i) {
+                expected[i] = p * double(gaps);
+                p *= 1 - hit;
+            }
+            expected[bins - 1] = std::pow(1 - hit, double(bins - 1)) * double(gaps);
+            double chi2 = chi_square(m_histogram, expected, bins);
+            return report("gap", chi_square_z(chi2, bins - 1), std::to_string(gaps) + " gaps");
+        }
+    private:
+        uint64_t m_gap = 0;
+        uint64_t m_histogram[bins] = {};
+    };
+
+    //Per-position and adjacent pair frequencies of characters of string IDs
+    class symbol_test {
+    public:
+        symbol_test(std::string_view alphabet, size_t length):
+            m_alphabet(alphabet),
+            m_length(length),
+            m_counts(length * alphabet.size()),
+            m_pairs(alphabet.size() * alphabet.size()) {
+
+            for (size_t i = 0; i < m_alphabet.size(); ++i)
+                m_reverse[uint8_t(m_alphabet[i])] = uint8_t(i);
+        }
+
+        void add(std::string_view chars, size_t first_pos = 0) {
+            size_t prev = 0;
+            for (size_t pos = first_pos; pos < m_length; ++pos) {
+                size_t idx = m_reverse[uint8_t(chars[pos])];
+                ++m_counts[pos * m_alphabet.size() + idx];
+                if (pos > first_pos)
+                    ++m_pairs[prev * m_alphabet.size() + idx];
+                prev = idx;
+            }
+        }
+        void merge(const symbol_test & other) {
+            for (size_t i = 0; i < m_counts.size(); ++i)
+                m_counts[i] += other.m_counts[i];
+            for (size_t i = 0; i < m_pairs.size(); ++i)
+                m_pairs[i] += other.m_pairs[i];
+        }
+        bool evaluate(size_t first_pos = 0) const {
+            auto size = m_alphabet.size();
+            std::vector<double> expected(size * size);
+            double worst = 0;
+            size_t worst_pos = 0;
+            for (size_t pos = first_pos; pos < m_length; ++pos) {
+                uint64_t total = 0;
+                for (size_t i = 0; i < size; ++i)
+                    total += m_counts[pos * size + i];
+                std::fill(expected.begin(), expected.begin() + size, double(total) / double(size));
+                double z = chi_square_z(chi_square(&m_counts[pos * size], expected.data(), size), double(size - 1));
+                if (std::abs(z) > std::abs(worst)) {
+                    worst = z;
+                    worst_pos = pos;
+                }
+            }
+            bool ok = report("symbol frequency", worst, "worst at char " + std::to_string(worst_pos));
+
+            if (m_length - first_pos < 2)
+                return ok;
+
+            uint64_t total = 0;
+            for (auto count: m_pairs)
+                total += count;
+            std::fill(expected.begin(), expected.end(), double(total) / double(size * size));
+            double z = chi_square_z(chi_square(m_pairs.data(), expected.data(), size * size), double(size * size - 1));
+            ok = report("symbol pairs", z, std::to_string(size * size) + " bins") && ok;
+            return ok;
+        }
+    private:
+        std::string_view m_alphabet;
+        size_t m_length;
+        std::vector<uint64_t> m_counts;
+        std::vector<uint64_t> m_pairs;
+        uint8_t m_reverse[256] = {};
+    };
+
+    struct bits_stats {
+        bits_stats(const record & mask): stream(mask) {}
+
+        word_stream stream;
+        bit_bias_test bias;
+        birthday_spacing_test birthday;
+        gap_test gap;
+
+        void add(const record & rec) {
+            bias.add(rec);
+            stream.feed(rec, [this](uint32_t word) {
+                birthday.add(word);
+                gap.add(word);
+            });
+        }
+        void merge(const bits_stats & other) {
+            bias.merge(other.bias);
+            birthday.merge(other.birthday);
+            gap.merge(other.gap);
+        }
+        bool evaluate(const record & mask) const {
+            bool ok = bias.evaluate(mask);
+            ok = birthday.evaluate() && ok;
+            ok = gap.evaluate() && ok;
+            return ok;
+        }
+    };
+
+    auto mask_from_bits(unsigned first, unsigned last) -> record {
+        record ret{};
+        for (unsigned i = first; i < last; ++i)
+            ret[i / 8] |= uint8_t(0x80 >> (i % 8));
+        return ret;
+    }
+
+    template<class Stats, class MakeStats, class Generate>
+    auto collect(uint64_t count, unsigned thread_count, MakeStats make_stats, Generate generate) -> Stats {
+        std::vector<Stats> stats;
+        for (unsigned i = 0; i < thread_count; ++i)
+            stats.push_back(make_stats());
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < thread_count; ++i) {
+            uint64_t thread_ids = count / thread_count + (i < count % thread_count);
+            threads.emplace_back([&, i, thread_ids]() {
+                for (uint64_t j = 0; j < thread_ids; ++j)
+                    generate(stats[i]);
+            });
+        }
+        for (auto & thread: threads)
+            thread.join();
+        for (unsigned i = 1; i < thread_count; ++i)
+            stats[0].merge(stats[i]);
+        return std::move(stats[0]);
+    }
+
+    struct options {
+        uint64_t count = 64'000'000;
+        unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+        std::vector<std::string> sources;
+    };
+
+    struct source {
+        const char * name;
+        //relative to the main count, for slow generators
+        unsigned divisor;
+        bool (*run)(uint64_t count, unsigned threads);
+    };
+
+    template<class Id, Id (*Generate)()>
+    bool run_bits(uint64_t count, unsigned threads, const record & mask) {
+        auto stats = collect<bits_stats>(count, threads, [&]() { return bits_stats(mask); }, [&](bits_stats & s) {
+            auto id = Generate();
+            record rec;
+            memcpy(rec.data(), id.bytes.data(), rec.size());
+            for (size_t i = 0; i < rec.size(); ++i)
+                rec[i] &= mask[i];
+            s.add(rec);
+        });
+        return stats.evaluate(mask);
+    }
+
+    template<class Id, class Alphabet, size_t Length>
+    bool run_symbols(uint64_t count, unsigned threads) {
+        constexpr std::string_view alphabet(Alphabet::chars, sizeof(Alphabet::chars) - 1);
+        auto stats = collect<symbol_test>(count, threads, [&]() { return symbol_test(alphabet, Length); },
+                                          [&](symbol_test & s) {
+            auto chars = Id::generate().to_chars();
+            s.add(std::string_view(chars.data(), chars.size()));
+        });
+        return stats.evaluate();
+    }
+
+    struct base64_chars { static constexpr char chars[] = "useandom-26T198340PX75pxJACKVERYMINDBUSHWOLF_GQZbfghjklqvwyzrict"; };
+    struct base36_chars { static constexpr char chars[] = "0123456789abcdefghijklmnopqrstuvwxyz"; };
+    struct digit_chars { static constexpr char chars[] = "0123456789"; };
+    struct letter_chars { static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyz"; };
+
+    //The first character of CUID2 is a letter and the rest are base36 digits
+    template<class Id, Id (*Generate)()>
+    bool run_cuid2(uint64_t count, unsigned threads) {
+        struct cuid2_stats {
+            symbol_test first{letter_chars::chars, 1};
+            symbol_test rest{base36_chars::chars, Id::char_length};
+
+            void merge(const cuid2_stats & other) {
+                first.merge(other.first);
+                rest.merge(other.rest);
+            }
+        };
+        auto stats = collect<cuid2_stats>(count, threads, []() { return cuid2_stats(); }, [](cuid2_stats & s) {
+            auto chars = Generate().to_chars();
+            std::string_view str(chars.data(), chars.size());
+            s.first.add(str);
+            s.rest.add(str, 1);
+        });
+        bool ok = stats.first.evaluate();
+        return stats.rest.evaluate(1) && ok;
+    }
+
+    const source g_sources[] = {
+        {"uuid v4", 1, [](uint64_t count, unsigned threads) {
+            //all but version and variant
+            auto mask = mask_from_bits(0, 128);
+            mask[6] &= 0x0F;
+            mask[8] &= 0x3F;
+            return run_bits<uuid, uuid::generate_random>(count, threads, mask);
+        }},
+        {"uuid v7", 1, [](uint64_t count, unsigned threads) {
+            //rand_a and the first 14 bits of rand_b hold sub-millisecond time and clock sequence
+            return run_bits<uuid, uuid::generate_unix_time_based>(count, threads, mask_from_bits(80, 128));
+        }},
+        {"ulid unordered", 1, [](uint64_t count, unsigned threads) {
+            return run_bits<ulid, ulid::generate_unordered>(count, threads, mask_from_bits(48, 128));
+        }},
+        {"nanoid", 1, [](uint64_t count, unsigned threads) {
+            //21 6-bit characters occupy the lowest 126 bits
+            bool ok = run_bits<nanoid, nanoid::generate>(count, threads, mask_from_bits(2, 128));
+            return run_symbols<nanoid, base64_chars, nanoid::char_length>(count, threads) && ok;
+        }},
+        {"nanoid base36", 1, [](uint64_t count, unsigned threads) {
+            return run_symbols<nanoid36, base36_chars, nanoid36::char_length>(count, threads);
+        }},
+        {"nanoid digits", 1, [](uint64_t count, unsigned threads) {
+            return run_symbols<nanoid10, digit_chars, nanoid10::char_length>(count, threads);
+        }},
+        {"cuid2", 2, run_cuid2<cuid2, cuid2::generate>},
+        {"cuid2 fast", 1, run_cuid2<cuid2, cuid2::generate_fast>},
+        {"cuid2 10", 2, run_cuid2<basic_cuid2<10>, basic_cuid2<10>::generate>},
+        {"cuid2 10 fast", 1, run_cuid2<basic_cuid2<10>, basic_cuid2<10>::generate_fast>},
+    };
+
+    bool parse_options(int argc, char ** argv, options & opts) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg == "--count" || arg == "--threads" || arg == "--threshold") {
+                if (i + 1 == argc)
+                    return false;
+                char * end;
+                const char * str = argv[++i];
+                double val = std::strtod(str, &end);
+                if (end == str || *end != 0 || !(val > 0))
+                    return false;
+                if (arg == "--count")
+                    opts.count = uint64_t(val);
+                else if (arg == "--threads")
+                    opts.threads = unsigned(val);
+                else
+                    g_threshold = val;
+            } else if (arg.starts_with("-")) {
+                return false;
+            } else {
+                opts.sources.emplace_back(arg);
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char ** argv) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        std::printf(
+            "Usage: randomness [options] [source...]\n"
+            "  --count N       IDs to test per source, default 64e6 (slow sources use less)\n"
+            "  --threads N     threads to use, default: hardware threads\n"
+            "  --threshold Z   maximum allowed |z| of any statistic, default 5\n");
+        return EXIT_FAILURE;
+    }
+
+    int failed = 0;
+    for (auto & src: g_sources) {
+        if (!opts.sources.empty() && std::find(opts.sources.begin(), opts.sources.end(), src.name) == opts.sources.end())
+            continue;
+        uint64_t count = std::max<uint64_t>(opts.count / src.divisor, 1);
+        std::printf("%s: %" PRIu64 " IDs\n", src.name, count);
+        std::fflush(stdout);
+        auto start = std::chrono::steady_clock::now();
+        bool ok = src.run(count, opts.threads);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  %s in %.1f s\n", ok ? "PASSED" : "FAILED", elapsed);
+        std::fflush(stdout);
+        if (!ok)
+            ++failed;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
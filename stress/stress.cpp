@@ -0,0 +1,522 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+//Large scale uniqueness and monotonicity check for all generators.
+//
+//IDs are generated by multiple threads in multiple (forked) processes. Each thread checks that
+//the IDs it produces are strictly increasing (for time-ordered kinds) as it goes and appends them
+//to per-partition files, partitioned by a hash of the ID. Afterwards each partition, sized to fit
+//into the memory budget, is loaded, sorted and checked for duplicates.
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<unistd.h>) && __has_include(<sys/wait.h>) && __has_include(<sys/mman.h>) && \
+    !defined(__MINGW32__) && !defined(__EMSCRIPTEN__)
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/wait.h>
+    #define MUUID_STRESS_HAS_FORK 1
+#endif
+
+using namespace muuid;
+using namespace std::literals;
+
+namespace {
+
+    using record = std::array<uint8_t, 16>;
+    using stress_clock = std::chrono::steady_clock;
+
+    struct options {
+        uint64_t count = 1'000'000'000;
+        unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+        unsigned processes = 4;
+        uint64_t memory_mb = 1024;
+        std::filesystem::path dir;
+        std::vector<std::string> kinds;
+    };
+
+    //Lives in memory shared between the coordinator and worker processes
+    struct shared_counters {
+        std::atomic<uint64_t> generated;
+        std::atomic<uint64_t> order_violations;
+        std::atomic<uint64_t> io_errors;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    struct run_config {
+        std::filesystem::path dir;
+        unsigned processes;
+        unsigned threads;
+        unsigned partition_bits;
+        shared_counters * counters;
+    };
+
+    struct no_order {};
+
+    template<class OrderKey>
+    struct order_key_of {
+        using type = std::decay_t<std::invoke_result_t<OrderKey, const record &>>;
+    };
+    template<>
+    struct order_key_of<no_order> {
+        using type = int;
+    };
+
+    auto seconds_since(stress_clock::time_point start) -> double {
+        return std::chrono::duration<double>(stress_clock::now() - start).count();
+    }
+
+    auto partition_of(const record & rec, unsigned partition_bits) -> size_t {
+        if (partition_bits == 0)
+            return 0;
+        uint64_t a, b;
+        memcpy(&a, rec.data(), 8);
+        memcpy(&b, rec.data() + 8, 8);
+        uint64_t h = a * 0x9E3779B97F4A7C15u ^ b;
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93u;
+        h ^= h >> 32;
+        return size_t(h >> (64 - partition_bits));
+    }
+
+    auto partition_file(const run_config & config, unsigned proc, unsigned thread, size_t part) {
+        return config.dir / (std::to_string(part) + "-" + std::to_string(proc) + "-" + std::to_string(thread) + ".bin");
+    }
+
+    auto to_hex(const record & rec) -> std::string {
+        std::string ret;
+        char buf[3];
+        for (auto byte: rec) {
+            std::snprintf(buf, sizeof(buf), "%02x", byte);
+            ret += buf;
+        }
+        return ret;
+    }
+
+    //Buffers records per partition and appends them to this writer's partition files
+    class partition_writer {
+    public:
+        partition_writer(const run_config & config, unsigned proc, unsigned thread):
+            m_config(config),
+            m_proc(proc),
+            m_thread(thread),
+            m_buffers(size_t(1) << config.partition_bits) {
+
+            //keep all buffers of a thread within ~8MB
+            m_buffer_size = std::max<size_t>(256, (size_t(8) << 20) / sizeof(record) / m_buffers.size());
+            for (auto & buf: m_buffers)
+                buf.reserve(m_buffer_size);
+        }
+        ~partition_writer() {
+            for (size_t part = 0; part < m_buffers.size(); ++part)
+                flush(part);
+        }
+        partition_writer(const partition_writer &) = delete;
+        partition_writer & operator=(const partition_writer &) = delete;
+
+        void add(const record & rec) {
+            auto part = partition_of(rec, m_config.partition_bits);
+            auto & buf = m_buffers[part];
+            buf.push_back(rec);
+            if (buf.size() == m_buffer_size)
+                flush(part);
+        }
+    private:
+        void flush(size_t part) {
+            auto & buf = m_buffers[part];
+            if (buf.empty())
+                return;
+            auto path = partition_file(m_config, m_proc, m_thread, part);
+            bool ok = false;
+            if (FILE * fp = std::fopen(path.string().c_str(), "ab")) {
+                ok = std::fwrite(buf.data(), sizeof(record), buf.size(), fp) == buf.size();
+                ok = (std::fclose(fp) == 0) && ok;
+            }
+            if (!ok)
+                m_config.counters->io_errors.fetch_add(1, std::memory_order_relaxed);
+            buf.clear();
+        }
+    private:
+        const run_config & m_config;
+        unsigned m_proc;
+        unsigned m_thread;
+        std::vector<std::vector<record>> m_buffers;
+        size_t m_buffer_size;
+    };
+
+    template<class Generate, class OrderKey>
+    void generate_ids(const run_config & config, unsigned proc, unsigned thread, uint64_t count,
+                      Generate generate, OrderKey order_key) {
+        constexpr uint64_t report_every = 0x10000;
+
+        partition_writer writer(config, proc, thread);
+        bool has_prev = false;
+        typename order_key_of<OrderKey>::type prev{};
+        uint64_t violations = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            record rec = generate();
+            writer.add(rec);
+            if constexpr (!std::is_same_v<OrderKey, no_order>) {
+                auto key = order_key(rec);
+                if (has_prev && !(prev < key)) {
+                    if (violations++ == 0)
+                        std::printf("  order violation in process %u thread %u: %s\n", proc, thread, to_hex(rec).c_str());
+                }
+                prev = key;
+                has_prev = true;
+            }
+            if ((i + 1) % report_every == 0)
+                config.counters->generated.fetch_add(report_every, std::memory_order_relaxed);
+        }
+        config.counters->generated.fetch_add(count % report_every, std::memory_order_relaxed);
+        config.counters->order_violations.fetch_add(violations, std::memory_order_relaxed);
+    }
+
+    template<class Generate, class OrderKey>
+    void run_process(const run_config & config, unsigned proc, uint64_t count, Generate generate, OrderKey order_key) {
+        std::vector<std::thread> threads;
+        for (unsigned thread = 0; thread < config.threads; ++thread) {
+            uint64_t thread_count = count / config.threads + (thread < count % config.threads);
+            threads.emplace_back([&, thread, thread_count]() {
+                generate_ids(config, proc, thread, thread_count, generate, order_key);
+            });
+        }
+        for (auto & thread: threads)
+            thread.join();
+    }
+
+    void report_progress(const run_config & config, uint64_t count, stress_clock::time_point start) {
+        auto generated = config.counters->generated.load(std::memory_order_relaxed);
+        auto elapsed = seconds_since(start);
+        std::printf("  generated %14" PRIu64 " (%5.1f%%) %8.2f M/s\n", generated,
+                    count ? 100.0 * double(generated) / double(count) : 100.0,
+                    elapsed > 0 ? double(generated) / elapsed / 1e6 : 0.0);
+        std::fflush(stdout);
+    }
+
+    template<class Generate, class OrderKey>
+    bool generate_all(const run_config & config, uint64_t count, Generate generate, OrderKey order_key) {
+
+        constexpr auto report_interval = 5s;
+
+        //make children inherit an already initialized generator state
+        generate();
+
+        auto start = stress_clock::now();
+    #if MUUID_STRESS_HAS_FORK
+        std::fflush(stdout);
+        std::vector<pid_t> children;
+        bool ok = true;
+        for (unsigned proc = 0; proc < config.processes; ++proc) {
+            uint64_t proc_count = count / config.processes + (proc < count % config.processes);
+            auto pid = fork();
+            if (pid == 0) {
+                run_process(config, proc, proc_count, generate, order_key);
+                std::fflush(stdout);
+                _exit(0);
+            }
+            if (pid < 0) {
+                std::printf("  fork() failed: %s\n", std::strerror(errno));
+                ok = false;
+                break;
+            }
+            children.push_back(pid);
+        }
+        auto last_report = start;
+        while (!children.empty()) {
+            std::this_thread::sleep_for(50ms);
+            for (auto it = children.begin(); it != children.end(); ) {
+                int status;
+                auto res = waitpid(*it, &status, WNOHANG);
+                if (res == 0 || (res < 0 && errno == EINTR)) {
+                    ++it;
+                    continue;
+                }
+                if (res < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    std::printf("  worker process %d failed\n", int(*it));
+                    ok = false;
+                }
+                it = children.erase(it);
+            }
+            if (stress_clock::now() - last_report >= report_interval) {
+                report_progress(config, count, start);
+                last_report = stress_clock::now();
+            }
+        }
+        if (!ok)
+            return false;
+    #else
+        std::atomic<bool> done = false;
+        std::thread worker([&]() {
+            run_process(config, 0, count, generate, order_key);
+            done = true;
+        });
+        auto last_report = start;
+        while (!done) {
+            std::this_thread::sleep_for(50ms);
+            if (stress_clock::now() - last_report >= report_interval) {
+                report_progress(config, count, start);
+                last_report = stress_clock::now();
+            }
+        }
+        worker.join();
+    #endif
+        auto elapsed = seconds_since(start);
+        auto generated = config.counters->generated.load();
+        auto violations = config.counters->order_violations.load();
+        std::printf("  generation: %" PRIu64 " IDs in %.1f s, %.2f M/s, order violations: %" PRIu64 "\n",
+                    generated, elapsed, double(generated) / elapsed / 1e6, violations);
+        return generated == count && violations == 0 && config.counters->io_errors.load() == 0;
+    }
+
+    bool check_uniqueness(const run_config & config, uint64_t count) {
+        auto start = stress_clock::now();
+        uint64_t total = 0;
+        uint64_t duplicates = 0;
+        std::vector<record> records;
+        for (size_t part = 0; part < (size_t(1) << config.partition_bits); ++part) {
+            records.clear();
+            for (unsigned proc = 0; proc < config.processes; ++proc) {
+                for (unsigned thread = 0; thread < config.threads; ++thread) {
+                    auto path = partition_file(config, proc, thread, part);
+                    std::error_code ec;
+                    auto size = std::filesystem::file_size(path, ec);
+                    if (ec)
+                        continue;
+                    auto offset = records.size();
+                    records.resize(offset + size / sizeof(record));
+                    FILE * fp = std::fopen(path.string().c_str(), "rb");
+                    if (!fp || std::fread(records.data() + offset, sizeof(record), records.size() - offset, fp) != records.size() - offset) {
+                        std::printf("  cannot read %s\n", path.string().c_str());
+                        if (fp)
+                            std::fclose(fp);
+                        return false;
+                    }
+                    std::fclose(fp);
+                    std::filesystem::remove(path, ec);
+                }
+            }
+            std::sort(records.begin(), records.end());
+            for (auto it = records.begin(); ; ++it) {
+                it = std::adjacent_find(it, records.end());
+                if (it == records.end())
+                    break;
+                if (duplicates++ < 10)
+                    std::printf("  duplicate: %s\n", to_hex(*it).c_str());
+            }
+            total += records.size();
+        }
+        auto elapsed = seconds_since(start);
+        std::printf("  dedup: %" PRIu64 " IDs in %zu partitions in %.1f s, %.2f M/s, duplicates: %" PRIu64 "\n",
+                    total, size_t(1) << config.partition_bits, elapsed, double(total) / elapsed / 1e6, duplicates);
+        if (total != count)
+            std::printf("  expected %" PRIu64 " IDs\n", count);
+        return total == count && duplicates == 0;
+    }
+
+    auto timestamp_v1(const record & rec) -> uint64_t {
+        return (uint64_t(rec[6] & 0x0F) << 56) | (uint64_t(rec[7]) << 48) |
+               (uint64_t(rec[4]) << 40) | (uint64_t(rec[5]) << 32) |
+               (uint64_t(rec[0]) << 24) | (uint64_t(rec[1]) << 16) | (uint64_t(rec[2]) << 8) | uint64_t(rec[3]);
+    }
+
+    auto whole_record(const record & rec) -> const record & {
+        return rec;
+    }
+
+    template<class Id, Id (*Generate)()>
+    auto generate_record() -> record {
+        static_assert(sizeof(Id::bytes) == sizeof(record));
+        auto id = Generate();
+        record ret;
+        memcpy(ret.data(), id.bytes.data(), ret.size());
+        return ret;
+    }
+
+    struct kind {
+        const char * name;
+        bool (*run)(const run_config & config, uint64_t count);
+    };
+
+    template<auto Generate, auto OrderKey>
+    bool run_kind(const run_config & config, uint64_t count) {
+        if (!generate_all(config, count, Generate, OrderKey))
+            return false;
+        return check_uniqueness(config, count);
+    }
+
+    template<auto Generate>
+    bool run_unordered_kind(const run_config & config, uint64_t count) {
+        if (!generate_all(config, count, Generate, no_order{}))
+            return false;
+        return check_uniqueness(config, count);
+    }
+
+    //v1 is not byte ordered and its clock sequence only changes on clock regression,
+    //so its monotonicity is checked on the timestamp alone
+    const kind g_kinds[] = {
+        {"v1",         run_kind<generate_record<uuid, uuid::generate_time_based>, timestamp_v1>},
+        {"v4",         run_unordered_kind<generate_record<uuid, uuid::generate_random>>},
+        {"v6",         run_kind<generate_record<uuid, uuid::generate_reordered_time_based>, whole_record>},
+        {"v7",         run_kind<generate_record<uuid, uuid::generate_unix_time_based>, whole_record>},
+        {"ulid",       run_kind<generate_record<ulid, ulid::generate>, whole_record>},
+        {"cuid2",      run_unordered_kind<generate_record<cuid2, cuid2::generate>>},
+        {"cuid2-fast", run_unordered_kind<generate_record<cuid2, cuid2::generate_fast>>},
+        {"nanoid",     run_unordered_kind<generate_record<nanoid, nanoid::generate>>},
+    };
+
+    bool parse_count(const char * str, uint64_t & count) {
+        char * end;
+        errno = 0;
+        auto val = std::strtoull(str, &end, 10);
+        if (errno != 0 || end == str)
+            return false;
+        uint64_t multiplier = 1;
+        switch (*end) {
+            case 'k': case 'K': multiplier = 1'000; ++end; break;
+            case 'm': case 'M': multiplier = 1'000'000; ++end; break;
+            case 'g': case 'G': multiplier = 1'000'000'000; ++end; break;
+        }
+        if (*end != 0)
+            return false;
+        count = uint64_t(val) * multiplier;
+        return true;
+    }
+
+    void usage() {
+        std::printf(
+            "Usage: stress [options] [kind...]\n"
+            "  --count N       IDs to generate per kind (k/m/g suffixes allowed), default 1g\n"
+            "  --threads N     threads per process, default: hardware threads\n"
+            "  --processes N   worker processes, default 4 where fork() is available\n"
+            "  --memory-mb N   memory budget for duplicate detection, default 1024\n"
+            "  --dir PATH      directory for temporary files, default: system temp directory\n"
+            "Kinds: v1 v4 v6 v7 ulid cuid2 cuid2-fast nanoid (default: all)\n");
+    }
+
+    bool parse_options(int argc, char ** argv, options & opts) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto next = [&]() -> const char * {
+                return i + 1 < argc ? argv[++i] : nullptr;
+            };
+            uint64_t val;
+            if (arg == "--count") {
+                auto str = next();
+                if (!str || !parse_count(str, opts.count))
+                    return false;
+            } else if (arg == "--threads" || arg == "--processes" || arg == "--memory-mb") {
+                auto str = next();
+                if (!str || !parse_count(str, val) || val == 0 || val > 0xFFFF)
+                    return false;
+                if (arg == "--threads")
+                    opts.threads = unsigned(val);
+                else if (arg == "--processes")
+                    opts.processes = unsigned(val);
+                else
+                    opts.memory_mb = val;
+            } else if (arg == "--dir") {
+                auto str = next();
+                if (!str)
+                    return false;
+                opts.dir = str;
+            } else if (arg.starts_with("-")) {
+                return false;
+            } else {
+                opts.kinds.emplace_back(arg);
+            }
+        }
+        return true;
+    }
+
+    auto allocate_counters() -> shared_counters * {
+    #if MUUID_STRESS_HAS_FORK
+        void * mem = mmap(nullptr, sizeof(shared_counters), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED)
+            return nullptr;
+        return new (mem) shared_counters{};
+    #else
+        static shared_counters counters{};
+        return &counters;
+    #endif
+    }
+}
+
+int main(int argc, char ** argv) {
+
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        usage();
+        return EXIT_FAILURE;
+    }
+#if !MUUID_STRESS_HAS_FORK
+    opts.processes = 1;
+#endif
+
+    if (opts.dir.empty())
+        opts.dir = std::filesystem::temp_directory_path() / ("muuid-stress-" + std::to_string(std::random_device{}()));
+
+    auto counters = allocate_counters();
+    if (!counters) {
+        std::printf("cannot allocate shared memory\n");
+        return EXIT_FAILURE;
+    }
+
+    //each partition must fit into the memory budget
+    unsigned partition_bits = 0;
+    while (partition_bits < 16 &&
+           (opts.count * sizeof(record) >> partition_bits) > (opts.memory_mb << 20))
+        ++partition_bits;
+
+    int failed = 0;
+    for (auto & kind: g_kinds) {
+        if (!opts.kinds.empty() && std::find(opts.kinds.begin(), opts.kinds.end(), kind.name) == opts.kinds.end())
+            continue;
+
+        run_config config{opts.dir / kind.name, opts.processes, opts.threads, partition_bits, counters};
+        std::error_code ec;
+        std::filesystem::remove_all(config.dir, ec);
+        if (!std::filesystem::create_directories(config.dir, ec)) {
+            std::printf("cannot create %s: %s\n", config.dir.string().c_str(), ec.message().c_str());
+            return EXIT_FAILURE;
+        }
+        counters->generated = 0;
+        counters->order_violations = 0;
+        counters->io_errors = 0;
+
+        std::printf("%s: %" PRIu64 " IDs, %u processes x %u threads, %zu partitions in %s\n",
+                    kind.name, opts.count, config.processes, config.threads, size_t(1) << partition_bits,
+                    config.dir.string().c_str());
+        std::fflush(stdout);
+
+        bool ok = kind.run(config, opts.count);
+        if (counters->io_errors.load() != 0)
+            std::printf("  I/O errors: %" PRIu64 "\n", counters->io_errors.load());
+        std::printf("  %s\n", ok ? "PASSED" : "FAILED");
+        std::fflush(stdout);
+        if (!ok)
+            ++failed;
+        std::filesystem::remove_all(config.dir, ec);
+    }
+    std::error_code ec;
+    std::filesystem::remove(opts.dir, ec);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/atomic_id.h>
+
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+
+TEST_SUITE("atomic_id") {
+
+//An ID with both halves derived from the same value so that torn reads can be detected
+template<class Id>
+static Id make_id(uint64_t val) {
+    std::array<uint8_t, 16> bytes{};
+    for (size_t i = 8; i > 0; --i, val >>= 8) {
+        bytes[i - 1] = uint8_t(val);
+        bytes[i + 7] = uint8_t(~val);
+    }
+    return Id(bytes);
+}
+
+template<class Id>
+static uint64_t value_of(const Id & id) {
+    uint64_t first = 0, last = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        first = (first << 8) | id.bytes[i];
+        last = (last << 8) | id.bytes[i + 8];
+    }
+    CHECK(first == ~last);
+    return first;
+}
+
+template<class Id>
+static void check_basics() {
+    atomic_id<Id> empty;
+    CHECK(empty.load() == Id());
+
+    const Id first = make_id<Id>(1), second = make_id<Id>(2), third = make_id<Id>(3);
+    atomic_id<Id> val(first);
+    CHECK(val.load() == first);
+    CHECK(Id(val) == first);
+
+    val.store(second);
+    CHECK(val.load(std::memory_order_acquire) == second);
+    val = first;
+    CHECK(val.load() == first);
+
+    CHECK(val.exchange(second) == first);
+    CHECK(val.load() == second);
+
+    Id expected = first;
+    CHECK(!val.compare_exchange_strong(expected, third));
+    CHECK(expected == second);
+    CHECK(val.load() == second);
+    CHECK(val.compare_exchange_strong(expected, third));
+    CHECK(expected == second);
+    CHECK(val.load() == third);
+    expected = third;
+    CHECK(val.compare_exchange_weak(expected, Id(), std::memory_order_acq_rel, std::memory_order_acquire));
+    CHECK(val.load() == Id());
+}
+
+TEST_CASE("basics") {
+    check_basics<uuid>();
+    check_basics<ulid>();
+    //the answer depends on the CPU but MUUID_CPU_TIER=generic always forces the seqlock
+    auto tier = getenv("MUUID_CPU_TIER");
+    if (tier && std::string_view(tier) == "generic")
+        CHECK(!atomic_id<uuid>().is_lock_free());
+}
+
+TEST_CASE("concurrency") {
+    constexpr unsigned thread_count = 4;
+    constexpr uint64_t increments = 20'000;
+    atomic_id<uuid> val(make_id<uuid>(0));
+
+    std::atomic<bool> done{false};
+    std::thread reader([&]() {
+        uint64_t last = 0;
+        while (!done.load()) {
+            uint64_t current = value_of(val.load());
+            CHECK(current >= last);
+            last = current;
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            auto expected = val.load();
+            for (uint64_t i = 0; i < increments; ) {
+                if (val.compare_exchange_weak(expected, make_id<uuid>(value_of(expected) + 1)))
+                    ++i;
+            }
+        });
+    }
+    for (auto & thread: threads)
+        thread.join();
+    done.store(true);
+    reader.join();
+    CHECK(value_of(val.load()) == thread_count * increments);
+}
+
+}
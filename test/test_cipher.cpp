@@ -0,0 +1,98 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/cipher.h>
+
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+
+TEST_SUITE("cipher") {
+
+static constexpr id_cipher::key_type test_key = {
+    0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00
+};
+
+TEST_CASE("known answer") {
+    //Speck128/128 test vector from the original paper
+    id_cipher cipher(test_key);
+    uuid plain("6c617669-7571-6520-7469-206564616d20");
+    uuid encrypted = cipher.encrypt(plain);
+    CHECK(encrypted == uuid("a65d9851-7978-3265-7860-fedf5c570d18"));
+    CHECK(cipher.decrypt(encrypted) == plain);
+}
+
+TEST_CASE("roundtrip") {
+    id_cipher cipher(test_key);
+
+    std::vector<uuid> uuids;
+    std::vector<ulid> ulids;
+    for (int i = 0; i < 21; ++i) {
+        uuids.push_back(uuid::generate_unix_time_based());
+        ulids.push_back(ulid::generate());
+    }
+
+    std::vector<uuid> encrypted_uuids(uuids.size());
+    cipher.encrypt(uuids, encrypted_uuids);
+    std::vector<ulid> encrypted_ulids(ulids.size());
+    cipher.encrypt(ulids, encrypted_ulids);
+    for (size_t i = 0; i < uuids.size(); ++i) {
+        CHECK(encrypted_uuids[i] == cipher.encrypt(uuids[i]));
+        CHECK(encrypted_uuids[i] != uuids[i]);
+        CHECK(cipher.decrypt(encrypted_uuids[i]) == uuids[i]);
+        CHECK(encrypted_ulids[i] == cipher.encrypt(ulids[i]));
+        CHECK(cipher.decrypt(encrypted_ulids[i]) == ulids[i]);
+    }
+
+    cipher.decrypt(encrypted_uuids, encrypted_uuids);
+    CHECK(encrypted_uuids == uuids);
+    cipher.decrypt(encrypted_ulids, encrypted_ulids);
+    CHECK(encrypted_ulids == ulids);
+
+    cipher.encrypt(std::span<const uuid>{}, std::span<uuid>{});
+    cipher.decrypt(std::span<const ulid>{}, std::span<ulid>{});
+    cipher.encrypt_preserving_version(std::span<const uuid>{}, std::span<uuid>{});
+
+    id_cipher other(std::array<uint8_t, 16>{1});
+    CHECK(other.encrypt(uuids[0]) != cipher.encrypt(uuids[0]));
+}
+
+TEST_CASE("preserving version") {
+    id_cipher cipher(test_key);
+
+    std::vector<uuid> uuids;
+    for (int i = 0; i < 19; ++i)
+        uuids.push_back(uuid::generate_unix_time_based());
+    uuids.push_back(uuid::generate_random());
+    uuids.push_back(uuid::max());
+    uuids.push_back(uuid());
+
+    std::vector<uuid> encrypted(uuids.size());
+    cipher.encrypt_preserving_version(uuids, encrypted);
+    for (size_t i = 0; i < uuids.size(); ++i) {
+        CHECK(encrypted[i] == cipher.encrypt_preserving_version(uuids[i]));
+        CHECK(encrypted[i] != uuids[i]);
+        if (uuids[i].get_variant() == uuid::variant::standard) {
+            CHECK(encrypted[i].get_variant() == uuid::variant::standard);
+            CHECK(encrypted[i].get_type() == uuids[i].get_type());
+        }
+        CHECK(cipher.decrypt_preserving_version(encrypted[i]) == uuids[i]);
+    }
+    cipher.decrypt_preserving_version(encrypted, encrypted);
+    CHECK(encrypted == uuids);
+}
+
+TEST_CASE("active kernels") {
+    auto kernels = active_kernels();
+    auto it = std::find_if(kernels.begin(), kernels.end(), [](const kernel_info & info) {
+        return info.name == "id_cipher";
+    });
+    REQUIRE(it != kernels.end());
+    CHECK(!it->tier.empty());
+}
+
+}
@@ -349,5 +349,67 @@ TEST_CASE("generate") {
     std::cout << "cuid2: " << u2 << '\n';
 }
 
+TEST_CASE("custom length") {
+    using cuid2_10 = basic_cuid2<10>;
+
+    static_assert(sizeof(basic_cuid2<2>) == 2);
+    static_assert(sizeof(cuid2_10) == 7);
+    static_assert(sizeof(basic_cuid2<32>) == 22);
+    static_assert(std::regular<cuid2_10>);
+
+    constexpr cuid2_10 c("tz4a98xxat");
+    constexpr std::array<uint8_t, 7> expected = {0x13,0x5a,0x1b,0x9c,0x27,0x92,0xd5};
+    CHECK_EQUAL_SEQ(c.bytes, expected);
+    CHECK_EQUAL_SEQ(c.to_chars(), "tz4a98xxat"sv);
+    CHECK(cuid2_10::from_chars("tz4a98xxat"sv) == c);
+    CHECK(!cuid2_10::from_chars("1z4a98xxat"sv));
+    CHECK(!cuid2_10::from_chars("tz4a98xxa"sv));
+    CHECK(std::hash<cuid2_10>{}(c) != std::hash<cuid2_10>{}(cuid2_10()));
+
+    CHECK_EQUAL_SEQ(cuid2_10().to_chars(), "a000000000"sv);
+    CHECK_EQUAL_SEQ(cuid2_10::max().to_chars(), "zzzzzzzzzz"sv);
+    CHECK(!cuid2_10::from_bytes(std::array<uint8_t, 7>{{25,255,255,255,255,255,255}}));
+    CHECK(cuid2_10::from_bytes(cuid2_10::max().bytes) == cuid2_10::max());
+
+    constexpr basic_cuid2<32> l("abcdefghijklmnopqrstuvwxyz012345");
+    CHECK_EQUAL_SEQ(l.to_chars(), "abcdefghijklmnopqrstuvwxyz012345"sv);
+    CHECK_EQUAL_SEQ(basic_cuid2<32>::max().to_chars(), "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz"sv);
+    constexpr basic_cuid2<2> s("x7");
+    CHECK_EQUAL_SEQ(s.to_chars(), "x7"sv);
+
+    auto g1 = cuid2_10::generate();
+    auto g2 = cuid2_10::generate_fast();
+    CHECK(g1 != g2);
+    CHECK(cuid2_10::from_chars(g1.to_chars()) == g1);
+    CHECK(cuid2_10::from_bytes(g2.bytes) == g2);
+
+    std::array<basic_cuid2<32>, 10> bulk;
+    basic_cuid2<32>::generate_fast(bulk);
+    for (auto & val: bulk)
+        CHECK(basic_cuid2<32>::from_chars(val.to_string()) == val);
+
+    std::cout << "cuid2<10>: " << g1 << ' ' << g2 << '\n';
+}
+
+TEST_CASE("generate fast") {
+    cuid2 u1 = cuid2::generate_fast();
+    cuid2 u2 = cuid2::generate_fast();
+    
+    CHECK(u1 != u2);
+    CHECK(u1 != cuid2());
+    
+    std::array<cuid2, 100> bulk;
+    cuid2::generate_fast(bulk);
+    for (auto & val: bulk) {
+        CHECK(cuid2::from_bytes(val.bytes) == val);
+        CHECK(cuid2::from_chars(val.to_chars()) == val);
+        CHECK(val != u1);
+    }
+    std::sort(bulk.begin(), bulk.end());
+    CHECK(std::adjacent_find(bulk.begin(), bulk.end()) == bulk.end());
+    
+    std::cout << "cuid2 fast: " << u1 << '\n';
+}
+
 }
 
@@ -0,0 +1,155 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/dedup.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+using namespace std::literals;
+
+TEST_SUITE("dedup") {
+
+static const dedup_cache<ulid>::clock::time_point start(1'700'000'000'000ms);
+
+static ulid make_ulid(dedup_cache<ulid>::clock::time_point when, uint64_t random) {
+    auto ms = uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()).count());
+    std::array<uint8_t, 16> bytes{};
+    for (size_t i = 6; i > 0; --i, ms >>= 8)
+        bytes[i - 1] = uint8_t(ms);
+    for (size_t i = 16; i > 8; --i, random >>= 8)
+        bytes[i - 1] = uint8_t(random);
+    return ulid(bytes);
+}
+
+TEST_CASE("basics") {
+    dedup_cache<ulid> cache(10s, 1s, 100);
+    CHECK(cache.bucket_count() == 13);
+
+    auto id = make_ulid(start, 1);
+    CHECK(!cache.contains(id, start));
+    CHECK(cache.insert(id, start) == dedup_result::inserted);
+    CHECK(cache.contains(id, start));
+    CHECK(cache.insert(id, start) == dedup_result::duplicate);
+    CHECK(cache.insert(id, start + 5s) == dedup_result::duplicate);
+
+    //same first 8 bytes, different last 8
+    auto other = make_ulid(start, 2);
+    CHECK(!cache.contains(other, start));
+    CHECK(cache.insert(other, start) == dedup_result::inserted);
+
+    CHECK(cache.insert(make_ulid(start - 10s, 1), start) == dedup_result::inserted);
+    CHECK(cache.insert(make_ulid(start - 10001ms, 1), start) == dedup_result::outside_window);
+    CHECK(cache.insert(make_ulid(start + 999ms, 1), start) == dedup_result::inserted);
+    CHECK(cache.insert(make_ulid(start + 1s, 1), start) == dedup_result::outside_window);
+    CHECK(!cache.contains(make_ulid(start + 1s, 1), start));
+}
+
+TEST_CASE("uuid") {
+    dedup_cache<uuid> cache(1min, 1s, 100);
+    auto v7 = uuid::generate_unix_time_based();
+    CHECK(cache.insert(v7) == dedup_result::inserted);
+    CHECK(cache.insert(v7) == dedup_result::duplicate);
+    CHECK(cache.contains(v7));
+    //no timestamp
+    auto v4 = uuid::generate_random();
+    CHECK(cache.insert(v4) == dedup_result::outside_window);
+    CHECK(!cache.contains(v4));
+}
+
+TEST_CASE("expiry") {
+    dedup_cache<ulid> cache(2s, 1s, 100);
+    auto id = make_ulid(start, 1);
+    CHECK(cache.insert(id, start) == dedup_result::inserted);
+    CHECK(cache.contains(id, start + 2s));
+    CHECK(!cache.contains(id, start + 3s));
+    CHECK(cache.insert(id, start + 3s) == dedup_result::outside_window);
+
+    //reuses the bucket that held the id
+    auto later = make_ulid(start + 1s * cache.bucket_count(), 1);
+    CHECK(cache.insert(later, start + 1s * cache.bucket_count()) == dedup_result::inserted);
+    //the old period is gone even for a caller with a stale clock
+    CHECK(!cache.contains(id, start));
+    CHECK(cache.insert(id, start) == dedup_result::outside_window);
+    CHECK(cache.contains(later, start + 1s * cache.bucket_count()));
+}
+
+TEST_CASE("full") {
+    dedup_cache<ulid> cache(2s, 1s, 4);
+    for (uint64_t i = 0; i < 4; ++i)
+        CHECK(cache.insert(make_ulid(start, i), start) == dedup_result::inserted);
+    CHECK(cache.insert(make_ulid(start, 4), start) == dedup_result::full);
+    CHECK(cache.insert(make_ulid(start, 3), start) == dedup_result::duplicate);
+    //other buckets are not affected
+    CHECK(cache.insert(make_ulid(start - 1s, 4), start) == dedup_result::inserted);
+}
+
+TEST_CASE("concurrency") {
+    constexpr unsigned thread_count = 4;
+    constexpr uint64_t id_count = 10'000;
+    dedup_cache<ulid> cache(10s, 100ms, id_count);
+
+    std::atomic<size_t> inserted{0}, duplicates{0};
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            for (uint64_t i = 0; i < id_count; ++i) {
+                auto id = make_ulid(start - 1ms * (i % 5000), i);
+                auto res = cache.insert(id, start);
+                if (res == dedup_result::inserted)
+                    ++inserted;
+                else if (res == dedup_result::duplicate)
+                    ++duplicates;
+            }
+        });
+    }
+    for (auto & thread: threads)
+        thread.join();
+    CHECK(inserted == id_count);
+    CHECK(duplicates == id_count * (thread_count - 1));
+}
+
+TEST_CASE("concurrent expiry") {
+    constexpr unsigned thread_count = 4;
+    constexpr size_t max_per_bucket = 8;
+    constexpr uint64_t iterations = 20'000;
+    constexpr uint64_t per_period = 4;
+    constexpr size_t period_count = iterations / per_period + 1;
+    //buckets are reused every few milliseconds while slower threads still insert into old ones
+    dedup_cache<ulid> cache(2ms, 1ms, max_per_bucket);
+
+    std::vector<std::atomic<size_t>> inserted(period_count);
+    std::vector<std::atomic<bool>> full(period_count);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                const uint64_t now_period = i / per_period;
+                const uint64_t id_period = now_period - std::min(now_period, i % 3);
+                auto id = make_ulid(start + 1ms * id_period, t * iterations + i);
+                auto res = cache.insert(id, start + 1ms * now_period);
+                if (res == dedup_result::inserted)
+                    ++inserted[id_period];
+                else if (res == dedup_result::full)
+                    full[id_period] = true;
+            }
+        });
+    }
+    for (auto & thread: threads)
+        thread.join();
+    //IDs that were rejected because their period expired must not take room from later periods
+    for (size_t i = 0; i < period_count; ++i) {
+        CHECK(inserted[i] <= max_per_bucket);
+        if (full[i])
+            CHECK(inserted[i] == max_per_bucket);
+    }
+}
+
+}
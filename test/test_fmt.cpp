@@ -44,6 +44,7 @@ TEST_CASE("format cuid2") {
     CHECK(fmt::format("{}", cuid2("NC6BZMKMD014706RFDA898TO")) == "nc6bzmkmd014706rfda898to");
     CHECK(fmt::format("{:l}", cuid2("NC6BZMKMD014706RFDA898TO")) == "nc6bzmkmd014706rfda898to");
     CHECK(fmt::format("{:u}", cuid2("NC6BZMKMD014706RFDA898TO")) == "NC6BZMKMD014706RFDA898TO");
+    CHECK(fmt::format("{:u}", basic_cuid2<10>("tz4a98xxat")) == "TZ4A98XXAT");
 }
 
 }
@@ -0,0 +1,68 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+#include <unordered_set>
+
+#include "test_util.h"
+
+using namespace muuid;
+
+TEST_SUITE("hashing") {
+
+static_assert(fold_hash{}(uuid()) == 0);
+static_assert(mixing_hash{}(uuid("7d444840-9dc0-11d1-b245-5ffdce74fad2")) == hash_value(uuid("7d444840-9dc0-11d1-b245-5ffdce74fad2")));
+static_assert(id_hash{}(uuid("7d444840-9dc0-11d1-b245-5ffdce74fad2")) == hash_value(uuid("7d444840-9dc0-11d1-b245-5ffdce74fad2")));
+static_assert(id_hash{}(uuid("e1ed6a06-e2a1-4c1c-a0a8-6ddd6d5ac0e0")) == fold_hash{}(uuid("e1ed6a06-e2a1-4c1c-a0a8-6ddd6d5ac0e0")));
+
+TEST_CASE("siphash") {
+    //reference vectors for SipHash-2-4 with key 00..0f and message 00..N-1
+    constexpr std::array<uint8_t, 15> msg15 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14};
+    constexpr std::array<uint8_t, 16> msg16 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    CHECK(impl::siphash<2, 4>(0x0706050403020100, 0x0f0e0d0c0b0a0908, msg15) == 0xa129ca6149be45e5);
+    CHECK(impl::siphash<2, 4>(0x0706050403020100, 0x0f0e0d0c0b0a0908, msg16) == 0x3f2acc7f57c29bdb);
+}
+
+TEST_CASE("policies") {
+    uuid u4 = uuid::generate_random();
+    uuid u7 = uuid::generate_unix_time_based();
+    ulid ul = ulid::generate();
+    nanoid n = nanoid::generate();
+    cuid2 c = cuid2::generate();
+
+    CHECK(mixing_hash{}(u7) == std::hash<uuid>{}(u7));
+    CHECK(mixing_hash{}(ul) == std::hash<ulid>{}(ul));
+    CHECK(id_hash{}(u4) == fold_hash{}(u4));
+    CHECK(id_hash{}(u7) == mixing_hash{}(u7));
+    CHECK(id_hash{}(ul) == mixing_hash{}(ul));
+    CHECK(id_hash{}(n) == fold_hash{}(n));
+    CHECK(id_hash{}(c) == fold_hash{}(c));
+
+    constexpr std::array<uint8_t, 16> key1{1}, key2{2};
+    CHECK(keyed_hash(key1)(u7) == keyed_hash(key1)(u7));
+    CHECK(keyed_hash(key1)(u7) != keyed_hash(key2)(u7));
+    CHECK(keyed_hash{}(u7) == keyed_hash{}(u7));
+    CHECK(keyed_hash{}(n) != keyed_hash{}(nanoid::generate()));
+}
+
+TEST_CASE("containers") {
+    std::unordered_set<uuid, id_hash> by_type;
+    std::unordered_set<uuid, keyed_hash> keyed;
+    for (int i = 0; i < 100; ++i) {
+        auto u = (i % 2) ? uuid::generate_random() : uuid::generate_unix_time_based();
+        by_type.insert(u);
+        keyed.insert(u);
+    }
+    CHECK(by_type.size() == 100);
+    CHECK(keyed.size() == 100);
+    for (auto & u: by_type)
+        CHECK(keyed.contains(u));
+}
+
+}
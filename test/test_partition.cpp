@@ -0,0 +1,132 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/partition.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+using namespace std::literals;
+
+TEST_SUITE("partition") {
+
+template<class Id>
+static Id make_id(uint64_t ms, uint64_t random) {
+    std::array<uint8_t, 16> bytes{};
+    for (size_t i = 6; i > 0; --i, ms >>= 8)
+        bytes[i - 1] = uint8_t(ms);
+    for (size_t i = 16; i > 8; --i, random >>= 8)
+        bytes[i - 1] = uint8_t(random);
+    if constexpr (std::is_same_v<Id, uuid>) {
+        bytes[6] = 0x70 | (bytes[6] & 0x0f);
+        bytes[8] = 0x80 | (bytes[8] & 0x3f);
+    }
+    return Id(bytes);
+}
+
+template<class Id>
+static uint64_t timestamp_of(const Id & id) {
+    uint64_t ret = 0;
+    for (size_t i = 0; i < 6; ++i)
+        ret = (ret << 8) | id.bytes[i];
+    return ret;
+}
+
+//checks the result against std::stable_sort
+template<class Id>
+static void check_partition(std::vector<Id> ids, std::chrono::milliseconds period) {
+    auto has_ts = [](const Id & id) {
+        if constexpr (std::is_same_v<Id, uuid>)
+            return id.get_variant() == uuid::variant::standard && id.get_type() == uuid::type::unix_time_based;
+        else
+            return true;
+    };
+    const uint64_t width = uint64_t(period.count());
+    auto expected = ids;
+    std::stable_sort(expected.begin(), expected.end(), [&](const Id & lhs, const Id & rhs) {
+        if (has_ts(lhs) != has_ts(rhs))
+            return has_ts(lhs);
+        return has_ts(lhs) && timestamp_of(lhs) / width < timestamp_of(rhs) / width;
+    });
+
+    std::vector<time_partition> parts;
+    partition_by_time(std::span(ids), period, parts);
+    CHECK(ids == expected);
+
+    size_t pos = 0;
+    for (auto & part: parts) {
+        CHECK(part.begin == pos);
+        CHECK(part.end > part.begin);
+        CHECK(part.start.time_since_epoch().count() % period.count() == 0);
+        for (size_t i = part.begin; i < part.end; ++i) {
+            CHECK(timestamp_of(ids[i]) / width * width == uint64_t(part.start.time_since_epoch().count()));
+        }
+        pos = part.end;
+    }
+    for (size_t i = pos; i < ids.size(); ++i)
+        CHECK(!has_ts(ids[i]));
+}
+
+TEST_CASE("basics") {
+    constexpr uint64_t hour = 3'600'000;
+    const uint64_t base = 1'700'000'000'000 / hour * hour;
+
+    std::vector<uuid> ids = {
+        make_id<uuid>(base + 2 * hour + 5, 1),
+        make_id<uuid>(base + 10, 2),
+        uuid::generate_random(),
+        make_id<uuid>(base + 2 * hour, 3),
+        make_id<uuid>(base + hour - 1, 4),
+        uuid(),
+        make_id<uuid>(base + 1, 5)
+    };
+    auto original = ids;
+    std::vector<time_partition> parts(5);
+    partition_by_time(ids, 1h, parts);
+    REQUIRE(parts.size() == 2);
+    CHECK(parts[0].start == time_partition::time_point_t(std::chrono::milliseconds(base)));
+    CHECK(parts[0].begin == 0);
+    CHECK(parts[0].end == 3);
+    CHECK(parts[1].start == time_partition::time_point_t(std::chrono::milliseconds(base + 2 * hour)));
+    CHECK(parts[1].begin == 3);
+    CHECK(parts[1].end == 5);
+    CHECK(ids == std::vector<uuid>{original[1], original[4], original[6], original[0], original[3], original[2], original[5]});
+
+    std::vector<uuid> empty;
+    partition_by_time(empty, 1h, parts);
+    CHECK(parts.empty());
+
+    std::vector<uuid> no_timestamps = {uuid::generate_random(), uuid()};
+    original = no_timestamps;
+    partition_by_time(no_timestamps, 1h, parts);
+    CHECK(parts.empty());
+    CHECK(no_timestamps == original);
+}
+
+TEST_CASE("random") {
+    const uint64_t now = 1'700'000'000'000;
+    std::vector<uuid> uuids;
+    std::vector<ulid> ulids;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        uint64_t ms = now + (i * 7919) % 100'000;
+        uuids.push_back(i % 10 == 0 ? uuid::generate_random() : make_id<uuid>(ms, i));
+        ulids.push_back(make_id<ulid>(ms, i));
+    }
+    for (auto period: {1ms, 7ms, 1000ms, 3'600'000ms, 1'000'000'000'000'000ms}) {
+        check_partition(uuids, period);
+        check_partition(ulids, period);
+    }
+    //sparse timestamps use the fallback path
+    ulids.push_back(make_id<ulid>(now + 1'000'000'000, 1));
+    check_partition(ulids, 1ms);
+    ulids.push_back(make_id<ulid>(0xffff'ffff'ffff, 1));
+    check_partition(ulids, 1ms);
+    check_partition(ulids, 1h);
+}
+
+}
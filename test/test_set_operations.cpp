@@ -0,0 +1,135 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/set_operations.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+
+TEST_SUITE("set_operations") {
+
+//Values in a small range so that the inputs share many elements. Both halves of the ID vary
+//to exercise comparison of the high and low words.
+template<class Id>
+static Id make_id(uint64_t val) {
+    std::array<uint8_t, 16> bytes{};
+    uint64_t high = val / 5, low = (val % 5) * 0x0101010101010101;
+    for (size_t i = 8; i > 0; --i, high >>= 8, low >>= 8) {
+        bytes[i - 1] = uint8_t(high);
+        bytes[i + 7] = uint8_t(low);
+    }
+    return Id(bytes);
+}
+
+template<class Id>
+static std::vector<Id> make_sorted(std::mt19937_64 & rng, size_t size, uint64_t range) {
+    std::vector<Id> ret;
+    for (size_t i = 0; i < size; ++i)
+        ret.push_back(make_id<Id>(rng() % range));
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+//checks the results against std::set_*
+template<class Id>
+static void check_operations(const std::vector<Id> & lhs, const std::vector<Id> & rhs) {
+    std::vector<Id> expected, actual;
+
+    std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    actual.resize(lhs.size() + rhs.size());
+    size_t count = set_intersection(std::span(lhs), std::span(rhs), std::span(actual));
+    actual.resize(count);
+    CHECK(actual == expected);
+
+    expected.clear();
+    std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    actual.resize(lhs.size() + rhs.size());
+    count = set_difference(std::span(lhs), std::span(rhs), std::span(actual));
+    actual.resize(count);
+    CHECK(actual == expected);
+
+    expected.clear();
+    std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    actual.resize(lhs.size() + rhs.size());
+    count = set_union(std::span(lhs), std::span(rhs), std::span(actual));
+    actual.resize(count);
+    CHECK(actual == expected);
+}
+
+TEST_CASE("basics") {
+    std::vector<uuid> lhs = {make_id<uuid>(1), make_id<uuid>(3), make_id<uuid>(3), make_id<uuid>(7), make_id<uuid>(9)};
+    std::vector<uuid> rhs = {make_id<uuid>(3), make_id<uuid>(4), make_id<uuid>(9), make_id<uuid>(12)};
+    std::vector<uuid> dest(lhs.size() + rhs.size());
+
+    CHECK(set_intersection(std::span(lhs), std::span(rhs), std::span(dest)) == 2);
+    CHECK(dest[0] == make_id<uuid>(3));
+    CHECK(dest[1] == make_id<uuid>(9));
+
+    CHECK(set_difference(std::span(lhs), std::span(rhs), std::span(dest)) == 3);
+    CHECK(dest[0] == make_id<uuid>(1));
+    CHECK(dest[1] == make_id<uuid>(3));
+    CHECK(dest[2] == make_id<uuid>(7));
+
+    CHECK(set_union(std::span(lhs), std::span(rhs), std::span(dest)) == 7);
+
+    std::vector<uuid> empty;
+    CHECK(set_intersection(std::span(empty), std::span(rhs), std::span(dest)) == 0);
+    CHECK(set_difference(std::span(lhs), std::span(empty), std::span(dest)) == lhs.size());
+    CHECK(set_union(std::span(empty), std::span(rhs), std::span(dest)) == rhs.size());
+    CHECK(dest[0] == rhs[0]);
+
+    bool thrown = false;
+    try {
+        set_union(std::span(lhs), std::span(rhs), std::span(dest).first(8));
+    } catch(std::invalid_argument &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    thrown = false;
+    try {
+        set_difference(std::span(dest).first(2), std::span(rhs), std::span(dest).subspan(1));
+    } catch(std::invalid_argument &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+TEST_CASE("random") {
+    std::mt19937_64 rng(42);
+    struct params {
+        size_t lhs_size;
+        size_t rhs_size;
+        uint64_t range;
+    };
+    const params all_params[] = {
+        {0, 0, 10}, {1, 1, 2}, {5, 7, 10}, {100, 100, 150},
+        {1000, 1000, 100'000}, {1000, 1000, 500}, {2000, 2000, 20},
+        //skewed sizes use galloping
+        {3, 5000, 10'000}, {5000, 3, 10'000}, {40, 20'000, 25'000}, {20'000, 17, 1'000'000}
+    };
+    for (auto [lhs_size, rhs_size, range]: all_params) {
+        check_operations(make_sorted<uuid>(rng, lhs_size, range), make_sorted<uuid>(rng, rhs_size, range));
+        check_operations(make_sorted<ulid>(rng, lhs_size, range), make_sorted<ulid>(rng, rhs_size, range));
+    }
+    //real random IDs with little overlap
+    std::vector<uuid> lhs, rhs;
+    for (size_t i = 0; i < 3000; ++i)
+        lhs.push_back(uuid::generate_random());
+    rhs.assign(lhs.begin(), lhs.begin() + 1000);
+    for (size_t i = 0; i < 3000; ++i)
+        rhs.push_back(uuid::generate_random());
+    std::sort(lhs.begin(), lhs.end());
+    std::sort(rhs.begin(), rhs.end());
+    check_operations(lhs, rhs);
+    check_operations(rhs, lhs);
+}
+
+}
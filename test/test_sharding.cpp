@@ -0,0 +1,229 @@
+// Copyright (c) 2024, Eugene Gershnik
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <doctest/doctest.h>
+
+#include <modern-uuid/sharding.h>
+#include <modern-uuid/uuid.h>
+#include <modern-uuid/ulid.h>
+#include <modern-uuid/nanoid.h>
+#include <modern-uuid/cuid2.h>
+
+#include <cmath>
+#include <vector>
+
+#include "test_util.h"
+
+using namespace muuid;
+
+TEST_SUITE("sharding") {
+
+static_assert(shard_of(uuid(), 1) == 0);
+static_assert(shard_of(uuid("e1ed6a06-e2a1-4c1c-a0a8-6ddd6d5ac0e0"), 1000) < 1000);
+
+//Reference implementation from "A Fast, Minimal Memory, Consistent Hash Algorithm"
+static int32_t reference_jump_hash(uint64_t key, int32_t num_buckets) {
+    int64_t b = -1, j = 0;
+    while (j < num_buckets) {
+        b = j;
+        key = key * 2862933555777941757ULL + 1;
+        j = int64_t((b + 1) * (double(1LL << 31) / double((key >> 33) + 1)));
+    }
+    return int32_t(b);
+}
+
+TEST_CASE("jump hash") {
+    uint64_t key = 0x0123456789abcdef;
+    for (int i = 0; i < 1000; ++i) {
+        key = impl::shard_mix(key + i);
+        for (int32_t count: {1, 2, 3, 10, 1000, 65537, 0x7fffffff}) {
+            CHECK(impl::jump_hash(key, uint32_t(count)) == uint32_t(reference_jump_hash(key, count)));
+        }
+    }
+    CHECK(impl::jump_hash(key, 0xffffffff) < 0xffffffff);
+}
+
+TEST_CASE("stable keys") {
+    //these must not change between releases or platforms
+    CHECK(impl::shard_key(uuid("e1ed6a06-e2a1-4c1c-a0a8-6ddd6d5ac0e0")) == (0xe0c05a6ddd6da8a0 ^ 0x1c4ca1e2066aede1));
+    CHECK(shard_of(uuid("e1ed6a06-e2a1-4c1c-a0a8-6ddd6d5ac0e0"), 1000) == 
+          impl::jump_hash(0xe0c05a6ddd6da8a0 ^ 0x1c4ca1e2066aede1, 1000));
+    CHECK(impl::shard_key(uuid("017f22e2-79b0-7cc3-98c4-dc0c0c07398f")) == 
+          impl::shard_mix(impl::shard_mix(0xc37cb079e2227f01) ^ 0x8f39070c0cdcc498));
+}
+
+TEST_CASE("consistency") {
+    std::vector<uuid> ids(10'000);
+    for (size_t i = 0; i < ids.size(); ++i)
+        ids[i] = (i % 2) ? uuid::generate_random() : uuid::generate_unix_time_based();
+
+    for (uint32_t count: {1u, 7u, 100u}) {
+        size_t moved = 0;
+        for (auto & id: ids) {
+            auto before = shard_of(id, count);
+            auto after = shard_of(id, count + 1);
+            CHECK(before < count);
+            if (after != before) {
+                CHECK(after == count);
+                ++moved;
+            }
+        }
+        //about 1/(count + 1) of ids should move
+        CHECK(moved > ids.size() / (count + 1) / 2);
+        CHECK(moved < ids.size() / (count + 1) * 2);
+    }
+
+    std::vector<uint64_t> shards = {11, 22, 33, 44, 55};
+    std::vector<uint64_t> fewer = {11, 22, 44, 55};
+    for (auto & id: ids) {
+        auto before = rendezvous_shard_of(id, shards);
+        auto after = rendezvous_shard_of(id, fewer);
+        CHECK(before < shards.size());
+        if (before != 2)
+            CHECK(fewer[after] == shards[before]);
+    }
+}
+
+TEST_CASE("balance") {
+    //time-based IDs generated in a burst differ only in a few bits
+    constexpr uint32_t count = 10;
+    std::vector<uuid> ids(100'000);
+    for (auto & id: ids)
+        id = uuid::generate_unix_time_based();
+    std::vector<uint64_t> shards = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    
+    size_t jump[count] = {}, rendezvous[count] = {};
+    for (auto & id: ids) {
+        ++jump[shard_of(id, count)];
+        ++rendezvous[rendezvous_shard_of(id, shards)];
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK(jump[i] > 9'000);
+        CHECK(jump[i] < 11'000);
+        CHECK(rendezvous[i] > 9'000);
+        CHECK(rendezvous[i] < 11'000);
+    }
+}
+
+TEST_CASE("bulk") {
+    std::vector<uuid> uuids(1003);
+    std::vector<ulid> ulids(uuids.size());
+    std::vector<nanoid> nanoids(uuids.size());
+    for (size_t i = 0; i < uuids.size(); ++i) {
+        uuids[i] = (i % 3) ? uuid::generate_random() : uuid::generate_unix_time_based();
+        //non-standard variant
+        if (i % 7 == 0)
+            uuids[i].bytes[8] &= 0x7f;
+        ulids[i] = ulid::generate();
+        nanoids[i] = nanoid::generate();
+    }
+    std::vector<uint64_t> shards = {0xdeadbeef, 3, 0, 17, 0xffffffffffffffff, 42, 5};
+
+    std::vector<uint32_t> dest(uuids.size());
+    for (uint32_t count: {1u, 5u, 1000u, 0xffffffffu}) {
+        shard_of(uuids, count, dest);
+        for (size_t i = 0; i < uuids.size(); ++i)
+            CHECK(dest[i] == shard_of(uuids[i], count));
+        shard_of(std::span<const ulid>(ulids), count, dest);
+        for (size_t i = 0; i < ulids.size(); ++i)
+            CHECK(dest[i] == shard_of(ulids[i], count));
+        shard_of(nanoids, count, dest);
+        for (size_t i = 0; i < nanoids.size(); ++i)
+            CHECK(dest[i] == shard_of(nanoids[i], count));
+    }
+
+    rendezvous_shard_of(uuids, shards, dest);
+    for (size_t i = 0; i < uuids.size(); ++i)
+        CHECK(dest[i] == rendezvous_shard_of(uuids[i], shards));
+    rendezvous_shard_of(ulids, shards, dest);
+    for (size_t i = 0; i < ulids.size(); ++i)
+        CHECK(dest[i] == rendezvous_shard_of(ulids[i], shards));
+
+    //only min(ids, dest) elements are written
+    std::vector<uint32_t> small(3, 0xffffffff);
+    shard_of(std::span(uuids).first(2), 1, small);
+    CHECK(small == std::vector<uint32_t>{0, 0, 0xffffffff});
+}
+
+TEST_CASE("sampling") {
+    static_assert(!sampled(uuid(), 0));
+    static_assert(sampled(uuid(), 1));
+    static_assert(sampled(uuid(), 0.5)); //key of nil is 0
+
+    MUUID_DECLARE_NANOID_ALPHABET(digits, "0123456789");
+    using digitid = basic_nanoid<digits, 10>;
+
+    const size_t size = 10'000;
+    std::vector<uuid> uuids(size);
+    std::vector<nanoid> nanoids(size);
+    std::vector<digitid> digitids(size);
+    std::vector<basic_cuid2<10>> cuids(size);
+    for (size_t i = 0; i < size; ++i) {
+        uuids[i] = (i % 2) ? uuid::generate_random() : uuid::generate_unix_time_based();
+        nanoids[i] = nanoid::generate();
+        digitids[i] = digitid::generate();
+        cuids[i] = basic_cuid2<10>::generate();
+    }
+
+    auto check = [](auto & ids) {
+        for (double rate: {0.0, 0.001, 0.01, 0.1, 0.5, 0.62, 1.0}) {
+            size_t count = 0;
+            for (auto & id: ids) {
+                bool res = sampled(id, rate);
+                count += res;
+                //lower rate samples are a subset
+                if (res)
+                    CHECK(sampled(id, std::min(rate * 2, 1.0)));
+            }
+            //within 5 standard deviations of the binomial distribution
+            const double expected = rate * double(ids.size());
+            const double deviation = 5 * std::sqrt(expected * (1 - rate));
+            CHECK(double(count) >= expected - deviation);
+            CHECK(double(count) <= expected + deviation);
+        }
+    };
+    check(uuids);
+    check(nanoids);
+    check(digitids);
+    check(cuids);
+
+    CHECK(!sampled(uuids[0], -1));
+    CHECK(sampled(uuids[0], 2));
+}
+
+TEST_CASE("bulk sampling") {
+    std::vector<uuid> uuids(1001);
+    std::vector<ulid> ulids(uuids.size());
+    std::vector<nanoid> nanoids(uuids.size());
+    for (size_t i = 0; i < uuids.size(); ++i) {
+        uuids[i] = (i % 2) ? uuid::generate_random() : uuid::generate_unix_time_based();
+        ulids[i] = ulid::generate();
+        nanoids[i] = nanoid::generate();
+    }
+
+    auto check = [](auto & ids, double rate) {
+        std::vector<uint64_t> mask((ids.size() + 63) / 64, ~uint64_t(0));
+        size_t count = sampled(ids, rate, mask);
+        size_t expected = 0;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            bool res = sampled(ids[i], rate);
+            expected += res;
+            CHECK(bool(mask[i / 64] & (uint64_t(1) << (i % 64))) == res);
+        }
+        CHECK(count == expected);
+        //unused bits are cleared
+        CHECK((mask.back() >> (ids.size() % 64)) == 0);
+    };
+    for (double rate: {0.0, 0.25, 1.0}) {
+        check(uuids, rate);
+        check(ulids, rate);
+        check(nanoids, rate);
+    }
+
+    //only as many IDs as fit in the mask are processed
+    std::vector<uint64_t> small(1);
+    CHECK(sampled(uuids, 1.0, small) == 64);
+    CHECK(small[0] == ~uint64_t(0));
+}
+
+}
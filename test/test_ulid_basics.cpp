@@ -11,6 +11,7 @@
 #include <map>
 #include <unordered_map>
 #include <thread>
+#include <cstring>
 
 #include "test_util.h"
 
@@ -347,4 +348,76 @@ TEST_CASE("generate") {
     std::cout << "ulid: " << u3 << '\n';
 }
 
-}
\ No newline at end of file
+TEST_CASE("generate_unordered") {
+    ulid u1 = ulid::generate_unordered();
+    ulid u2 = ulid::generate_unordered();
+    CHECK(u1 != u2);
+    CHECK(ulid() < u1);
+    CHECK(u1 < ulid::max());
+
+    std::vector<ulid> many(11);
+    ulid::generate_unordered(many);
+    for (size_t i = 0; i < many.size(); ++i) {
+        CHECK(memcmp(many[i].bytes.data(), many[0].bytes.data(), 6) == 0);
+        for (size_t j = i + 1; j < many.size(); ++j)
+            CHECK(many[i] != many[j]);
+    }
+    CHECK(memcmp(u1.bytes.data(), many[0].bytes.data(), 6) <= 0);
+}
+
+TEST_CASE("generate into records") {
+    struct row {
+        ulid id;
+        uint16_t payload = 7;
+    };
+    std::vector<row> rows(200);
+    ulid::generate_into(rows, &row::id);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        CHECK(rows[i].payload == 7);
+        if (i > 0)
+            CHECK(rows[i - 1].id < rows[i].id);
+    }
+    CHECK(rows.back().id < ulid::generate());
+
+    std::vector<row> unordered_rows(11);
+    ulid::generate_unordered_into(unordered_rows, &row::id);
+    for (size_t i = 0; i < unordered_rows.size(); ++i) {
+        CHECK(unordered_rows[i].payload == 7);
+        CHECK(memcmp(unordered_rows[i].id.bytes.data(), unordered_rows[0].id.bytes.data(), 6) == 0);
+        for (size_t j = i + 1; j < unordered_rows.size(); ++j)
+            CHECK(unordered_rows[i].id != unordered_rows[j].id);
+    }
+
+    ulid::generate_into(&rows[0].id, sizeof(row), 1);
+    CHECK(rows[1].id < rows[0].id);
+}
+
+TEST_CASE("observe") {
+    auto set_time = [](ulid u, std::chrono::milliseconds when) {
+        uint64_t val = uint64_t(when.count());
+        for (size_t i = 6; i-- > 0; val >>= 8)
+            u.bytes[i] = uint8_t(val);
+        return u;
+    };
+    auto get_time = [](ulid u) {
+        uint64_t val = 0;
+        for (size_t i = 0; i < 6; ++i)
+            val = (val << 8) | u.bytes[i];
+        return std::chrono::milliseconds(int64_t(val));
+    };
+    //the local clock may already be ahead of the system one due to other tests
+    auto now = get_time(ulid::generate());
+
+    ulid remote = set_time(ulid::generate(), now + 100ms);
+    REQUIRE(ulid::generate() < remote);
+    CHECK(observe(remote));
+    ulid u1 = ulid::generate();
+    ulid u2 = ulid::generate();
+    CHECK(remote < u1);
+    CHECK(u1 < u2);
+
+    CHECK(!observe(set_time(remote, now + 1h)));
+    CHECK(!observe(ulid::max()));
+}
+
+}
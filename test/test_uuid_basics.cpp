@@ -6,6 +6,7 @@
 #include <modern-uuid/uuid.h>
 
 #include <vector>
+#include <list>
 #include <sstream>
 #include <iostream>
 #include <map>
@@ -337,6 +338,41 @@ TEST_CASE("random") {
     CHECK(u2 < uuid::max());
 }
 
+TEST_CASE("random into records") {
+    struct row {
+        int before = 1;
+        uuid id;
+        char after = 2;
+    };
+    std::vector<row> rows(100);
+    uuid::generate_random_into(rows, &row::id);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        CHECK(rows[i].before == 1);
+        CHECK(rows[i].after == 2);
+        CHECK(rows[i].id.get_variant() == uuid::variant::standard);
+        CHECK(rows[i].id.get_type() == uuid::type::random);
+        if (i > 0)
+            CHECK(rows[i].id != rows[i - 1].id);
+    }
+
+    //non-contiguous ranges go through a buffer
+    std::list<row> list_rows(70);
+    uuid::generate_random_into(list_rows, [](row & r) -> uuid & { return r.id; });
+    for (auto & r: list_rows) {
+        CHECK(r.id.get_type() == uuid::type::random);
+        CHECK(r.after == 2);
+    }
+
+    std::vector<uuid> plain(3);
+    uuid::generate_random_into(plain);
+    CHECK(plain[0].get_type() == uuid::type::random);
+    CHECK(plain[2].get_type() == uuid::type::random);
+    CHECK(plain[0] != plain[2]);
+
+    uuid::generate_random_into(&rows[0].id, sizeof(row), 0);
+    CHECK(rows[0].before == 1);
+}
+
 TEST_CASE("md5") {
     uuid u1 = uuid::generate_md5(uuid::namespaces::dns, "www.widgets.com");
     CHECK(u1 == uuid("3d813cbb-47fb-32ba-91df-831e1593ac29"));
@@ -418,4 +454,147 @@ TEST_CASE("unix_time_based") {
     std::cout << "v7: " << u3 << '\n';
 }
 
+TEST_CASE("unix_time_based into records") {
+    struct row {
+        uuid id;
+        uint32_t payload = 42;
+    };
+    //more than one batch of clock values
+    std::vector<row> rows(1000);
+    uuid::generate_unix_time_based_into(rows, &row::id);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        CHECK(rows[i].payload == 42);
+        CHECK(rows[i].id.get_variant() == uuid::variant::standard);
+        CHECK(rows[i].id.get_type() == uuid::type::unix_time_based);
+        if (i > 0)
+            CHECK(rows[i - 1].id < rows[i].id);
+    }
+    CHECK(rows.back().id < uuid::generate_unix_time_based());
+
+    std::list<uuid> list_ids(5);
+    uuid::generate_unix_time_based_into(list_ids);
+    CHECK(rows.back().id < list_ids.front());
+    CHECK(std::is_sorted(list_ids.begin(), list_ids.end()));
+}
+
+TEST_CASE("unix_time_based counter layout") {
+    struct restore {
+        ~restore() {
+            set_unix_time_based_layout(unix_time_based_layout::sub_millisecond);
+        }
+    } restore;
+
+    set_unix_time_based_layout(unix_time_based_layout::counter);
+
+    auto get_counter = [](const uuid & u) {
+        auto parts = u.to_parts();
+        return (uint64_t(parts.time_hi_and_version & 0x0FFF) << 30) | 
+               (uint64_t(parts.clock_seq & 0x3FFF) << 16) | 
+               (uint64_t(parts.node[0]) << 8) | parts.node[1];
+    };
+
+    std::vector<uuid> uuids(1000);
+    for (auto & u: uuids)
+        u = uuid::generate_unix_time_based();
+    for (size_t i = 0; i < uuids.size(); ++i) {
+        CHECK(uuids[i].get_variant() == uuid::variant::standard);
+        CHECK(uuids[i].get_type() == uuid::type::unix_time_based);
+        if (i > 0) {
+            CHECK(uuids[i - 1] < uuids[i]);
+            if (memcmp(uuids[i - 1].bytes.data(), uuids[i].bytes.data(), 6) == 0)
+                CHECK(get_counter(uuids[i - 1]) + 1 == get_counter(uuids[i]));
+        }
+    }
+    uuid::generate_unix_time_based_into(uuids);
+    for (size_t i = 1; i < uuids.size(); ++i) {
+        CHECK(uuids[i - 1] < uuids[i]);
+        if (memcmp(uuids[i - 1].bytes.data(), uuids[i].bytes.data(), 6) == 0)
+            CHECK(get_counter(uuids[i - 1]) + 1 == get_counter(uuids[i]));
+    }
+    std::cout << "v7 counter: " << uuids.front() << '\n';
+    std::cout << "v7 counter: " << uuids.back() << '\n';
+}
+
+TEST_CASE("unix_time_based layout switch") {
+    struct restore {
+        ~restore() {
+            set_unix_time_based_layout(unix_time_based_layout::sub_millisecond);
+        }
+    } restore;
+
+    std::vector<uuid> uuids(1, uuid::generate_unix_time_based());
+    for (int i = 0; i < 2000; ++i) {
+        set_unix_time_based_layout(i % 2 ? unix_time_based_layout::sub_millisecond : unix_time_based_layout::counter);
+        if (i % 3) {
+            uuids.push_back(uuid::generate_unix_time_based());
+        } else {
+            uuids.resize(uuids.size() + 3);
+            uuid::generate_unix_time_based_into(std::span(uuids).last(3));
+        }
+    }
+    for (size_t i = 1; i < uuids.size(); ++i)
+        CHECK(uuids[i - 1] < uuids[i]);
+}
+
+TEST_CASE("cpu clock source") {
+    struct restore {
+        ~restore() {
+            set_clock_source(clock_source::system);
+        }
+    } restore;
+
+    if (!set_clock_source(clock_source::cpu_counter)) {
+        WARN_MESSAGE(false, "CPU counter clock source is not available");
+        return;
+    }
+    auto to_ms = [](const uuid & u) {
+        uint64_t val = 0;
+        for (size_t i = 0; i < 6; ++i)
+            val = (val << 8) | u.bytes[i];
+        return std::chrono::milliseconds(int64_t(val));
+    };
+    auto sys_now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+    uuid prev = uuid::generate_unix_time_based();
+    for (int i = 0; i < 1000; ++i) {
+        uuid u = uuid::generate_unix_time_based();
+        CHECK(prev < u);
+        prev = u;
+    }
+    //the generated time can be ahead of the system due to observe() tests but never behind
+    CHECK(to_ms(prev) >= sys_now - 1ms);
+    CHECK(to_ms(prev) < sys_now + 1s);
+}
+
+TEST_CASE("unix_time_based observe") {
+    auto set_time = [](uuid u, std::chrono::milliseconds when) {
+        uint64_t val = uint64_t(when.count());
+        for (size_t i = 6; i-- > 0; val >>= 8)
+            u.bytes[i] = uint8_t(val);
+        return u;
+    };
+    auto get_time = [](uuid u) {
+        uint64_t val = 0;
+        for (size_t i = 0; i < 6; ++i)
+            val = (val << 8) | u.bytes[i];
+        return std::chrono::milliseconds(int64_t(val));
+    };
+    //the local clock may already be ahead of the system one due to other tests
+    auto now = get_time(uuid::generate_unix_time_based());
+
+    uuid remote = set_time(uuid::generate_unix_time_based(), now + 100ms);
+    REQUIRE(uuid::generate_unix_time_based() < remote);
+    CHECK(observe(remote));
+    uuid u1 = uuid::generate_unix_time_based();
+    uuid u2 = uuid::generate_unix_time_based();
+    CHECK(remote < u1);
+    CHECK(u1 < u2);
+
+    CHECK(observe(set_time(remote, now - 1h)));
+    CHECK(u2 < uuid::generate_unix_time_based());
+
+    CHECK(!observe(set_time(remote, now + 1h)));
+    CHECK(!observe(uuid::generate_random()));
+    CHECK(!observe(uuid::max()));
+}
+
 }
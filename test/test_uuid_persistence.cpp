@@ -5,6 +5,8 @@
 
 #include <modern-uuid/uuid.h>
 
+#include <modern-uuid/persistence.h>
+
 #include "persistence.h"
 
 #if MUUID_MULTITHREADED
@@ -61,6 +63,44 @@ public:
 };
 
 
+static auto time_of(const uuid & u) {
+    int64_t ms = 0;
+    for (int i = 0; i < 6; ++i)
+        ms = (ms << 8) | u.bytes[i];
+    return uuid_persistence_data::time_point_t(std::chrono::milliseconds(ms));
+}
+
+#if MUUID_SUPPORTS_COROUTINES
+
+namespace {
+    //Minimal eagerly started coroutine
+    struct detached_task {
+        struct promise_type {
+            detached_task get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    //Completes writes only when told to
+    class manual_async_persistence final : public async_clock_persistence<uuid_persistence_data> {
+    public:
+        manual_async_persistence(std::chrono::milliseconds margin = 10s): async_clock_persistence(nullptr, margin) {}
+
+        void complete(bool success) 
+            { store_completed(success); }
+
+        std::vector<uuid_persistence_data> stores;
+    private:
+        void start_store(const uuid_persistence_data & d) noexcept override 
+            { stores.push_back(d); }
+    };
+}
+
+#endif
+
 static auto g_path = std::filesystem::path("pers" + std::to_string(sys_getpid()) + ".bin");
 static file_clock_persistence<uuid_per_thread> pers(g_path);
 
@@ -315,6 +355,163 @@ TEST_CASE("clock unix_time_based") {
     CHECK(pers.ref_count() == 0);
 }
 
+TEST_CASE("clock borrow unix_time_based") {
+
+    {
+        struct restore_pers {
+            ~restore_pers() {
+                set_unix_time_based_max_clock_borrow(0ns);
+                set_unix_time_based_persistence(nullptr);
+                uuid::generate_unix_time_based();
+            }
+        } restore_pers;
+
+        //simulate the system clock going backwards by moving the persisted one forward
+        auto step_back = [](std::chrono::milliseconds by) {
+            uuid_per_thread file(g_path);
+            file.lock();
+            uuid_persistence_data data;
+            REQUIRE(file.load(data));
+            data.when += by;
+            file.store(data);
+            file.unlock();
+        };
+
+        remove(g_path);
+        set_unix_time_based_max_clock_borrow(1s);
+        set_unix_time_based_persistence(&pers);
+
+        uuid u0 = uuid::generate_unix_time_based();
+        auto stats0 = get_unix_time_based_clock_statistics();
+
+        step_back(200ms);
+        uuid u1 = uuid::generate_unix_time_based();
+        uuid u2 = uuid::generate_unix_time_based();
+        CHECK(u0 < u1);
+        CHECK(u1 < u2);
+
+        auto stats1 = get_unix_time_based_clock_statistics();
+        CHECK(stats1.regressions == stats0.regressions + 1);
+        CHECK(stats1.resets == stats0.resets);
+        CHECK(stats1.last_borrow > 100ms);
+        CHECK(stats1.max_borrow >= stats1.last_borrow);
+
+        set_unix_time_based_max_clock_borrow(10ms);
+        step_back(200ms);
+        uuid u3 = uuid::generate_unix_time_based();
+        CHECK(u3 < u2);
+
+        auto stats2 = get_unix_time_based_clock_statistics();
+        CHECK(stats2.resets == stats1.resets + 1);
+    }
+    uuid::generate_unix_time_based();
+    CHECK(pers.ref_count() == 0);
+}
+
+TEST_CASE("write behind unix_time_based") {
+
+    auto read_file = []() {
+        uuid_per_thread file(g_path);
+        std::lock_guard guard{file};
+        uuid_persistence_data data{};
+        REQUIRE(file.load(data));
+        return data;
+    };
+
+    remove(g_path);
+    uuid last;
+    {
+        write_behind_clock_persistence<uuid_persistence_data> write_behind(pers, 10ms, 500ms);
+        {
+            struct restore_pers {
+                ~restore_pers() {
+                    set_unix_time_based_persistence(nullptr);
+                    uuid::generate_unix_time_based();
+                }
+            } restore_pers;
+
+            set_unix_time_based_persistence(&write_behind);
+            uuid prev;
+            for (int i = 0; i < 1000; ++i) {
+                last = uuid::generate_unix_time_based();
+                REQUIRE(prev < last);
+                prev = last;
+            }
+
+            //the written timestamp must be ahead of everything issued
+            write_behind.flush();
+            auto deadline = std::chrono::steady_clock::now() + 5s;
+            uuid_persistence_data data;
+            do {
+                std::this_thread::sleep_for(10ms);
+                data = read_file();
+            } while (data.when < time_of(last) + 400ms && std::chrono::steady_clock::now() < deadline);
+            CHECK(data.when >= time_of(last) + 400ms);
+        }
+        CHECK(write_behind.ref_count() == 0);
+    }
+    CHECK(pers.ref_count() == 0);
+
+    //on shutdown the exact state is written
+    auto data = read_file();
+    CHECK(data.when >= time_of(last));
+    CHECK(data.when < time_of(last) + 100ms);
+}
+
+#if MUUID_SUPPORTS_COROUTINES
+
+TEST_CASE("async unix_time_based") {
+
+    manual_async_persistence async_pers;
+    {
+        struct restore_pers {
+            ~restore_pers() {
+                set_unix_time_based_persistence(nullptr);
+                uuid::generate_unix_time_based();
+            }
+        } restore_pers;
+
+        set_unix_time_based_persistence(&async_pers);
+
+        std::vector<uuid> results;
+        auto generate = [&]() -> detached_task {
+            for (int i = 0; i < 3; ++i)
+                results.push_back(co_await async_generate_unix_time_based(async_pers));
+        };
+        generate();
+
+        //nothing is written yet so the first generation waits for a write
+        REQUIRE(async_pers.stores.size() == 1);
+        CHECK(results.empty());
+
+        //failed writes are retried
+        async_pers.complete(false);
+        REQUIRE(async_pers.stores.size() == 2);
+        CHECK(results.empty());
+
+        //the rest are within the margin and complete without waiting
+        async_pers.complete(true);
+        REQUIRE(results.size() == 3);
+        CHECK(results[0] < results[1]);
+        CHECK(results[1] < results[2]);
+        CHECK(async_pers.stores.size() == 2);
+        CHECK(async_pers.stores.back().when >= time_of(results[2]) + 9s);
+    }
+    CHECK(async_pers.ref_count() == 0);
+}
+
+TEST_CASE("async margin must be positive") {
+    bool thrown = false;
+    try {
+        manual_async_persistence async_pers(0s);
+    } catch(std::invalid_argument &) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+#endif
+
 TEST_CASE("node time_based") {
 
     struct restore {